@@ -1,7 +1,7 @@
 "use client"
 
 import { Target, Swords, Sparkles } from 'lucide-react'
-import { MoveType } from "../helpers/constants"
+import { MoveType, moveKind } from "../helpers/constants"
 import { useChessContext } from "../hooks/useChessContext"
 
 function Square({ index }: { index: number }) {
@@ -18,8 +18,8 @@ function Square({ index }: { index: number }) {
       // Find the first movement that points to this 'index'
       moveCode = highlight.find((move) => (move & 0x3f) === index)
       if (moveCode !== undefined) {
-        // Extract move type (4 upper bits)
-        const moveType = moveCode >> 12
+        // Extract move type (4 upper bits, promotion piece dropped)
+        const moveType = moveKind(moveCode)
         isMoveTarget = index == (moveCode & 0x3f)
         switch (moveType) {
           case MoveType.MOVE:
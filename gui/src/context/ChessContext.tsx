@@ -5,7 +5,7 @@ import { getMoves } from "../helpers/engine_calls"
 import { useWebSocket } from "../hooks/useWebSocket"
 import { ChessContext } from "../hooks/useChessContext"
 import type { ServerResponse } from "../types/types"
-import { initialBoard, Piece } from "../helpers/constants"
+import { initialBoard, MoveType, Piece, moveKind, withPromotionPiece } from "../helpers/constants"
 
 const ChessProvider = ({ children }: { children: ReactNode }) => {
   const roleRef = useRef(null)
@@ -47,7 +47,7 @@ const ChessProvider = ({ children }: { children: ReactNode }) => {
   const [isPromoting, setIsPromoting] = useState<boolean>(false)
   const [gameMessage, setGameMessage] = useState<string>("")
 
-  const promotionRef = useRef<number | null>(null) // Para almanenar la casilla del peón a promover,
+  const promotionRef = useRef<number | null>(null) // Jugada de promoción a la espera de elegir pieza
   const socketRef = useRef<WebSocket | null>(null)
 
   // Hook WebSocket optimizado
@@ -248,11 +248,6 @@ const ChessProvider = ({ children }: { children: ReactNode }) => {
 
       // Handle game events
       switch (response.event) {
-        case "promotion":
-          setIsPromoting(true)
-          promotionRef.current = response.event_data
-          break
-
         case "none":
           if (response.status === "nextturn") {
             setIsUserTurn((prevState) => !prevState)
@@ -280,6 +275,11 @@ const ChessProvider = ({ children }: { children: ReactNode }) => {
           setIsUserTurn(false)
           break
 
+        case "draw":
+          setGameMessage("Game Over. Draw by repetition or fifty moves")
+          setIsUserTurn(false)
+          break
+
         default:
           console.warn("Unknown WebSocket event:", response.event)
       }
@@ -331,45 +331,60 @@ const ChessProvider = ({ children }: { children: ReactNode }) => {
     }
   }
 
-  const handlePromotionState = useCallback(
-    (promotion: number) => {
+  const sendUserMove = useCallback(
+    (move_code: number) => {
       if (!wsConnected()) {
         setGameMessage("No hay conexión")
-        return
+        return false
       }
 
       const success = send({
-        event: "promotion",
-        data: promotion % 6, // divide by 6 to ensure it's a piece type
+        event: "user_moves",
+        data: move_code,
       })
 
       if (success) {
+        setHighlight([])
+        setSelectedSquare(null)
+        setThreats(0n)
+        setGameMessage("")
+      }
+      return success
+    },
+    [send, wsConnected],
+  )
+
+  // The piece is chosen before sending, the whole promotion goes in one move code
+  const handlePromotionState = useCallback(
+    (promotion: number) => {
+      if (promotionRef.current === null) return
+
+      const move_code = withPromotionPiece(promotionRef.current, promotion % 6) // divide by 6 to ensure it's a piece type
+      if (sendUserMove(move_code)) {
         setIsPromoting(false)
         promotionRef.current = null
       }
     },
-    [send, wsConnected],
+    [sendUserMove],
   )
 
   const handleMoveState = useCallback(
     (move_code: number) => {
-      if (!wsConnected()) {
-        setGameMessage("No hay conexión")
+      const kind = moveKind(move_code)
+      if (kind === MoveType.PROMOTION || kind === MoveType.PROMOTION_CAPTURE) {
+        // Sin conexión no se abre el selector, la jugada no podría enviarse
+        if (!wsConnected()) {
+          setGameMessage("No hay conexión")
+          return
+        }
+        promotionRef.current = move_code
+        setIsPromoting(true)
+        return
       }
 
-      const success = send({
-        event: "user_moves",
-        data: move_code,
-      })
-
-      if (success) {
-        setHighlight([])
-        setSelectedSquare(null)
-        setThreats(0n)
-        setGameMessage("")
-      }
+      sendUserMove(move_code)
     },
-    [send, wsConnected],
+    [sendUserMove, wsConnected],
   )
 
   return (
@@ -1,12 +1,27 @@
+// Upper 4 bits of a move code. Promotions set bit 3, bit 2 marks a capture
+// and bits 0-1 hold the piece, in PromotionPieceTypes order
 export const MoveType = {
   MOVE: 0,
   CAPTURE: 1,
   CASTLING: 2,
   EN_PASSANT: 3,
-  PROMOTION: 4,
-  PROMOTION_CAPTURE: 5,
+  PROMOTION: 8,
+  PROMOTION_CAPTURE: 12,
 };
 
+// Piece types (0-5) a pawn can become: knight, bishop, rook, queen
+export const PromotionPieceTypes = [2, 0, 5, 4];
+
+// Move type without the promotion piece
+export const moveKind = (moveCode: number): number => {
+  const type = moveCode >> 12
+  return type & MoveType.PROMOTION ? type & 0b1100 : type
+}
+
+// Same move with another promotion piece (type 0-5)
+export const withPromotionPiece = (moveCode: number, pieceType: number): number =>
+  (moveCode & ~(0b11 << 12)) | (PromotionPieceTypes.indexOf(pieceType) << 12)
+
 export const Piece = {
     BLACK_BISHOP: 0,
     BLACK_KING: 1,
@@ -20,6 +20,6 @@ export interface ServerResponse {
   move_data?: [number, number, number, number];
   promotion_pc?: number;
   event_data: number;
-  event: "none" | "check" | "checkmate" | "stalemate" | "promotion";
-  status: "nextturn" | "awaiting";
+  event: "none" | "check" | "checkmate" | "stalemate" | "draw";
+  status: "nextturn" | "error";
 }
\ No newline at end of file
@@ -1,19 +1,92 @@
 import asyncio
-from typing import Optional, Dict
+import os
+from typing import Optional, Dict, List
 import time
 
 PATH = './src/engine'
 
+# Thinking time of each engine move (ms) when the caller gives no budget
+DEFAULT_MOVETIME = int(os.environ.get("ENGINE_MOVETIME", "1000"))
+
+
+class EnginePool:
+    """
+    One engine process hosting many games: commands go out as 'session <id> <command>'
+    and every response line comes back prefixed the same way, so a single reader
+    task can route it to the right game.
+    """
+    def __init__(self, workers: Optional[int] = None):
+        self.engine_path = PATH
+        self.workers = workers
+        self.proc: Optional[asyncio.subprocess.Process] = None
+        self.queues: Dict[str, asyncio.Queue] = {}
+        self.reader_task: Optional[asyncio.Task] = None
+        self.lock = asyncio.Lock()
+
+    async def start(self) -> None:
+        async with self.lock:
+            if self.proc and self.proc.returncode is None:
+                return
+
+            self.proc = await asyncio.create_subprocess_exec(
+                self.engine_path,
+                stdin=asyncio.subprocess.PIPE,
+                stdout=asyncio.subprocess.PIPE,
+                stderr=asyncio.subprocess.PIPE
+            )
+
+            if self.workers:
+                await self.send_raw(f'setoption name Workers value {self.workers}')
+            self.reader_task = asyncio.create_task(self._read_loop())
+
+    async def stop(self) -> None:
+        if self.proc and self.proc.returncode is None:
+            await self.send_raw('quit')
+            await self.proc.wait()
+        if self.reader_task:
+            self.reader_task.cancel()
+        self.proc = None
+        self.reader_task = None
+
+    async def send_raw(self, line: str) -> None:
+        self.proc.stdin.write(f"{line}\n".encode())
+        await self.proc.stdin.drain()
+
+    async def send(self, session_id: str, line: str) -> None:
+        await self.send_raw(f'session {session_id} {line}')
+
+    def queue_for(self, session_id: str) -> asyncio.Queue:
+        return self.queues.setdefault(session_id, asyncio.Queue())
+
+    def release(self, session_id: str) -> None:
+        self.queues.pop(session_id, None)
+
+    async def _read_loop(self) -> None:
+        while True:
+            raw = await self.proc.stdout.readline()
+            if not raw:
+                break
+            parts = raw.decode().strip().split(' ', 2)
+            if len(parts) >= 2 and parts[0] == 'session':
+                queue = self.queues.get(parts[1])
+                if queue is not None:
+                    queue.put_nowait(parts[2] if len(parts) == 3 else '')
+
 class GameManager:
     """
     Manages a UCI chess engine subprocess, sending commands and parsing responses.
     """
-    def __init__(self, color: int):
+    def __init__(self, color: int, pool: Optional[EnginePool] = None, session_id: Optional[str] = None):
         self.engine_path = PATH
         self.user_color = color
         self.proc: Optional[asyncio.subprocess.Process] = None
+        # With a pool the game lives in the shared engine process as a session
+        self.pool = pool
+        self.session_id = session_id
         self.last_activity = time.time()
         self.created_at = time.time()
+        # One command/response exchange at a time; "stop" skips it to cut a search short
+        self.lock = asyncio.Lock()
 
     def update_activity(self) -> None:
         """Update last activity timestamp"""
@@ -21,6 +94,14 @@ class GameManager:
 
     async def start(self) -> None:
         """Launch the engine and initialize UCI protocol."""
+        if self.pool:
+            await self.pool.start()
+            self.pool.queue_for(self.session_id)
+            await self._send_line('ucinewgame')
+            await self._read_until('readyok')
+            self.update_activity()
+            return
+
         if self.proc and self.proc.returncode is None:
             return
 
@@ -44,13 +125,30 @@ class GameManager:
 
     async def stop(self) -> None:
         """Shut down the engine subprocess."""
-        if self.proc and self.proc.returncode is None:
-            await self._send_line('quit')
-            await self.proc.wait()
-        self.proc = None
+        await self.cancel_search()
+        async with self.lock:
+            if self.pool:
+                await self._send_line('close')
+                await self._read_until('closed')
+                self.pool.release(self.session_id)
+                return
+
+            if self.proc and self.proc.returncode is None:
+                await self._send_line('quit')
+                await self.proc.wait()
+            self.proc = None
+
+    async def cancel_search(self) -> None:
+        """End a running enginego early; it still answers with the best move found so far."""
+        if self.pool or (self.proc and self.proc.returncode is None):
+            await self._send_line('stop')
             
 
     async def _send_line(self, line: str) -> None:
+        if self.pool:
+            await self.pool.send(self.session_id, line)
+            return
+
         if not self.proc:
             await self.start()
         
@@ -59,6 +157,9 @@ class GameManager:
 
 
     async def _read_line(self) -> str:
+        if self.pool:
+            return await self.pool.queue_for(self.session_id).get()
+
         raw = await self.proc.stdout.readline()
         return raw.decode().strip()
 
@@ -92,38 +193,62 @@ class GameManager:
             elif line == 'nextturn':
                 response['status'] = 'nextturn'
                 break
-            
-            elif line == 'awaiting':
-                response['status'] = 'awaiting'
+
+            elif line == 'error':
+                # Rejected command (e.g. an illegal makemove), the game is unchanged
+                response['status'] = 'error'
                 break
                 
         return response
 
     async def user_moves(self, move_code) -> Dict:
-        """Make a move via UCI makemove"""
+        """Make a move via UCI makemove, a promotion code already names the piece"""
         self.update_activity()
-        await self._send_line(f'makemove {move_code}')
-        return await self._parse_stream_response()
+        async with self.lock:
+            await self._send_line(f'makemove {move_code}')
+            return await self._parse_stream_response()
     
-    async def resolve_promotion(self, promotion) -> Dict:
-        """Resolves the promotion via UCI"""
+    async def engine_moves(self, movetime: Optional[int] = None, nodes: Optional[int] = None) -> Dict:
+        """Make a move via UCI enginego, bounded by movetime (ms) and/or nodes; DEFAULT_MOVETIME without either"""
         self.update_activity()
-        await self._send_line(f'promote {promotion}')
-        return await self._parse_stream_response()
-
-    async def engine_moves(self) -> Dict:
-        """Make a move via UCI enginego"""
+        if movetime is None and nodes is None:
+            movetime = DEFAULT_MOVETIME
+        command = 'enginego'
+        if movetime is not None:
+            command += f' movetime {movetime}'
+        if nodes is not None:
+            command += f' nodes {nodes}'
+        async with self.lock:
+            await self._send_line(command)
+            return await self._parse_stream_response()
+
+    async def set_position(self, fen: Optional[str] = None, moves: Optional[List[str]] = None) -> bool:
+        """Restore a game in one command: 'position fen <fen>|startpos moves m1 m2 ...'"""
         self.update_activity()
-        await self._send_line('enginego')
-        return await self._parse_stream_response()
+        command = f'position fen {fen}' if fen else 'position startpos'
+        if moves:
+            command += ' moves ' + ' '.join(moves)
+        async with self.lock:
+            await self._send_line(command)
+            await self._send_line('isready')
+
+            ok = True
+            while True:
+                line = await self._read_line()
+                if line == 'error':
+                    ok = False
+                elif line == 'readyok':
+                    return ok
 
     async def get_moves(self, square: int):
         """Retrieve legal moves from a square via custom getmoves command."""
-        await self._send_line(f'getmoves {square}')
-        moves = []
-        while True:
-            line = await self._read_line()
-            if line == 'readyok':
-                break
-            moves.append(int(line))
-        return moves
+        async with self.lock:
+            await self._send_line(f'getmoves {square}')
+            moves = []
+            while True:
+                line = await self._read_line()
+                if line in ('readyok', 'error'):
+                    break
+                if line.isdigit():  # skip the error text of an empty or enemy square
+                    moves.append(int(line))
+            return moves
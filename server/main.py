@@ -1,10 +1,11 @@
 from typing import Dict
 import asyncio
+import os
 from fastapi import FastAPI, WebSocket, WebSocketDisconnect
 from contextlib import asynccontextmanager
 from fastapi.middleware.cors import CORSMiddleware
 from router import engine_router
-from game_manager import GameManager
+from game_manager import GameManager, EnginePool, DEFAULT_MOVETIME
 import time
 
 
@@ -40,6 +41,9 @@ async def lifespan(app: FastAPI):
     # Store the instance in the app's state so it can be accessed by dependencies
     app.state.game_states = game_states
     app.state.game_states_lock = game_states_lock
+
+    # ENGINE_POOL=1 hosts every game as a session of one shared engine process
+    app.state.engine_pool = EnginePool() if os.environ.get("ENGINE_POOL") == "1" else None
     
     # Iniciar tarea de limpieza automática
     cleanup_task = asyncio.create_task(cleanup_inactive_games())
@@ -58,6 +62,9 @@ async def lifespan(app: FastAPI):
         for game_manager in game_states.values():
             await game_manager.stop()
 
+    if app.state.engine_pool:
+        await app.state.engine_pool.stop()
+
 
 app = FastAPI(lifespan=lifespan)
 
@@ -82,7 +89,7 @@ app.include_router(engine_router)
 
 """ Web Sockets connections from here"""
 
-# These ones are the possible engine messages: "none", "check", "checkmate", "stalemate", "promotion"
+# These ones are the possible engine messages: "none", "check", "checkmate", "stalemate", "draw"
 # Always from the user's perspective
 
 @app.websocket("/ws/{game_id}")
@@ -104,17 +111,16 @@ async def websocket_endpoint(websocket: WebSocket, game_id: str):
 
             response = None
 
+            # The global lock only guards the dictionary; the game serializes its own
+            # engine exchanges, so a long search no longer blocks the other games
             async with game_states_lock:
                 game_manager: GameManager = game_states.get(game_id)
-                
-                if event == "user_moves":
-                    response = await game_manager.user_moves(data) # here "data" is the move code
 
-                elif event == "engine_moves":
-                    response = await game_manager.engine_moves() # data is not needed here
+            if event == "user_moves":
+                response = await game_manager.user_moves(data) # here "data" is the move code, promotions include the piece
 
-                elif event == "promotion":
-                    response = await game_manager.resolve_promotion(data) # here "data" is the promotion
+            elif event == "engine_moves":
+                response = await game_manager.engine_moves(movetime=DEFAULT_MOVETIME) # data is not needed here
 
             if response:
                 print("ServerResponse: ", response)
@@ -125,10 +131,10 @@ async def websocket_endpoint(websocket: WebSocket, game_id: str):
         print("WEBSOCKET DISCONNECTION")
         
         async with game_states_lock:
-            game_manager: GameManager = game_states.get(game_id)
-            if game_manager:
-                print("ERASING DATA")
-                del game_states[game_id]
+            game_manager: GameManager = game_states.pop(game_id, None)
+        if game_manager:
+            print("ERASING DATA")
+            await game_manager.stop() # cancels a search still running for this game
         
     except Exception as e:
         print(f"An error occurred in websocket_endpoint: {e}")
@@ -1,7 +1,7 @@
 from asyncio import Lock
-from typing import Dict
+from typing import Dict, Optional, Set
 from fastapi import APIRouter, Depends, HTTPException, Request
-from game_manager import GameManager
+from game_manager import GameManager, EnginePool
 
 
 def get_game_states(request: Request) -> Dict[str, GameManager]:
@@ -11,22 +11,39 @@ def get_game_states(request: Request) -> Dict[str, GameManager]:
 def get_game_states_lock(request: Request) -> Lock:
     return request.app.state.game_states_lock
 
+
+def get_engine_pool(request: Request) -> Optional[EnginePool]:
+    return request.app.state.engine_pool
+
 engine_router = APIRouter()
 
+# Games whose engine is still starting, guarded by game_states_lock
+starting_games: Set[str] = set()
+
 @engine_router.post("/create/{user_color}/game/{game_id}")
 async def create_game(
     game_id: str,
     user_color: int, # 0 or 1 for black or white
     game_states: Dict[str, GameManager] = Depends(get_game_states),
-    game_states_lock: Lock = Depends(get_game_states_lock)
+    game_states_lock: Lock = Depends(get_game_states_lock),
+    engine_pool: Optional[EnginePool] = Depends(get_engine_pool)
 ):
+    # The id is reserved under the lock, the engine starts without it: in pool mode
+    # start() waits behind other sessions' searches and must not block other requests
     async with game_states_lock:
-        if game_id in game_states:
+        if game_id in game_states or game_id in starting_games:
             raise HTTPException(status_code=400, detail=f"Game {game_id} already exists")
-        # Instantiate and start a new engine
-        gm = GameManager(user_color)
+        starting_games.add(game_id)
+
+    try:
+        # Instantiate and start a new engine, or a session in the shared one
+        gm = GameManager(user_color, engine_pool, game_id)
         await gm.start()
-        game_states[game_id] = gm
+        async with game_states_lock:
+            game_states[game_id] = gm
+    finally:
+        async with game_states_lock:
+            starting_games.discard(game_id)
     return {"game_id": game_id}
 
 
@@ -3,9 +3,11 @@
 
 #include "../constants/Types.h"
 #include "../constants/StaticData.h"
+#include "../constants/ColorTraits.h"
 #include "../constants/PSQ_tables.h"
 #include "../constants/Rays.h"
 #include "../constants/Helpers.h"
+#include "../constants/Zobrist.h"
 #include "../precomputed_moves/non_sliding_moves/data.h"
 #include "../precomputed_moves/sliding_moves/data.h"
 
@@ -21,6 +23,8 @@ private:
     std::array<uint64_t, 12> types_bb_array;        // Bitboards by piece type
     uint64_t occupied_bb;                            // All occupied squares
     std::array<uint64_t, 2> colors_bb_array;        // Bitboards by color
+    uint64_t hash_key;                               // Zobrist key, updated incrementally
+    int psq_score;                                   // Material + PSQ from white's view, updated incrementally
 
 public:
     // =========================
@@ -32,6 +36,7 @@ public:
     }
     
     void setStartPosition();
+    bool setFromFen(const std::string& placement); // piece placement field only
 
     // =========================
     // FAST INLINE ACCESSORS
@@ -64,6 +69,26 @@ public:
         return types_bb_array[c == WHITE ? WHITE_KING : BLACK_KING];
     }
 
+    // Knights, bishops, rooks and queens of one side
+    inline uint64_t non_pawn_pieces(Color c) const noexcept {
+        int offset = c * PC_NUM;
+        return colors_bb_array[c] & ~types_bb_array[PAWN + offset] & ~types_bb_array[KING + offset];
+    }
+
+    inline uint64_t key() const noexcept {
+        return hash_key;
+    }
+
+    // Material + PSQ balance, white positive
+    inline int psq() const noexcept {
+        return psq_score;
+    }
+
+    // Game uses this to fold side to move, castling and en passant into the key
+    inline void xor_key(uint64_t k) noexcept {
+        hash_key ^= k;
+    }
+
     // =========================
     // BOARD MANIPULATION
     // =========================
@@ -76,9 +101,7 @@ public:
     // GAME LOGIC FUNTIONS
     // =========================
 
-    uint64_t getPseudoLegalMoves(int fromSq) const;
     void castling(int from_sq, int to_sq, bool reverse = false );
-    Piece promote(int promotion_sq, Type promotion = QUEEN);
 
     // =========================
     // ATTACK & THREAT QUERIES
@@ -88,6 +111,21 @@ public:
     uint64_t getLinearThreats(Color sideToMove) const;
     uint64_t getRayBetween(Color sideToMove, int sq) const;
 
+    // Versiones con plantilla de color para el generador, Us es el bando que mueve.
+    // Las de arriba despachan a estas
+    template <Color Us> uint64_t attackers_to(int sq) const noexcept;
+    template <Color Us> uint64_t linear_threats() const noexcept;
+    template <Color Us> uint64_t pseudo_legal_moves(int from_sq, Type type) const noexcept;
+
+    // Pieces of both colors attacking sq with the given occupancy (x-rays appear
+    // as occupancy shrinks)
+    uint64_t all_attackers_to(int sq, uint64_t occupancy) const noexcept;
+
+    // Static exchange evaluation: material balance for the mover after the full
+    // sequence of captures on the target square, each side recapturing with its
+    // least valuable piece and free to stop
+    int see(uint16_t move_code) const;
+
     // =========================
     // UTILITY & DEBUG
     // =========================
@@ -115,3 +153,84 @@ public:
         }
     }
 };
+
+
+// Enemy pieces attacking sq
+template <Color Us>
+inline uint64_t BoardState::attackers_to(int sq) const noexcept {
+    using Traits = ColorTraits<Us>;
+    constexpr int enemy = Traits::enemy_offset;
+
+    uint64_t attackers = (types_bb_array[KING + enemy] & king_lookup[sq])
+                       | (types_bb_array[KNIGHT + enemy] & knight_lookup[sq])
+                       | (types_bb_array[PAWN + enemy] & Traits::pawn_attacks()[sq]);
+
+    uint64_t diagonal = types_bb_array[BISHOP + enemy] | types_bb_array[QUEEN + enemy];
+    uint64_t straight = types_bb_array[ROOK + enemy] | types_bb_array[QUEEN + enemy];
+
+    return attackers
+         | (bishop_attacks(sq, occupied_bb) & diagonal)
+         | (rook_attacks(sq, occupied_bb) & straight);
+}
+
+// Enemy sliders lined up with our king, only enemy pieces block (pin candidates)
+template <Color Us>
+inline uint64_t BoardState::linear_threats() const noexcept {
+    constexpr int enemy = ColorTraits<Us>::enemy_offset;
+    int king_sq = __builtin_ctzll(types_bb_array[KING + ColorTraits<Us>::own_offset]);
+    uint64_t enemy_bb = colors_bb_array[ColorTraits<Us>::them];
+
+    uint64_t diagonal = types_bb_array[BISHOP + enemy] | types_bb_array[QUEEN + enemy];
+    uint64_t straight = types_bb_array[ROOK + enemy] | types_bb_array[QUEEN + enemy];
+
+    return (bishop_attacks(king_sq, enemy_bb) & diagonal)
+         | (rook_attacks(king_sq, enemy_bb) & straight);
+}
+
+inline uint64_t BoardState::all_attackers_to(int sq, uint64_t occupancy) const noexcept {
+    uint64_t diagonal = types_bb_array[WHITE_BISHOP] | types_bb_array[WHITE_QUEEN]
+                      | types_bb_array[BLACK_BISHOP] | types_bb_array[BLACK_QUEEN];
+    uint64_t straight = types_bb_array[WHITE_ROOK] | types_bb_array[WHITE_QUEEN]
+                      | types_bb_array[BLACK_ROOK] | types_bb_array[BLACK_QUEEN];
+
+    return ((types_bb_array[WHITE_KING] | types_bb_array[BLACK_KING]) & king_lookup[sq])
+         | ((types_bb_array[WHITE_KNIGHT] | types_bb_array[BLACK_KNIGHT]) & knight_lookup[sq])
+         | (types_bb_array[WHITE_PAWN] & black_pawn_attacks_lookup[sq])
+         | (types_bb_array[BLACK_PAWN] & white_pawn_attacks_lookup[sq])
+         | (bishop_attacks(sq, occupancy) & diagonal)
+         | (rook_attacks(sq, occupancy) & straight);
+}
+
+template <Color Us>
+inline uint64_t BoardState::pseudo_legal_moves(int from_sq, Type type) const noexcept {
+    using Traits = ColorTraits<Us>;
+    uint64_t moves = 0;
+
+    switch (type) {
+        case KNIGHT:
+            moves = knight_lookup[from_sq];
+            break;
+        case KING:
+            moves = king_lookup[from_sq];
+            break;
+        case PAWN: {
+            // Obstáculo directo frente al peón: tampoco hay doble avance
+            uint64_t pushes = (occupied_bb >> (from_sq + Traits::push)) & 1ULL
+                            ? 0ULL
+                            : Traits::pawn_pushes()[from_sq] & ~occupied_bb;
+            moves = pushes | (Traits::pawn_attacks()[from_sq] & occupied_bb);
+            break;
+        }
+        case ROOK:
+            moves = rook_attacks(from_sq, occupied_bb);
+            break;
+        case BISHOP:
+            moves = bishop_attacks(from_sq, occupied_bb);
+            break;
+        case QUEEN:
+            moves = rook_attacks(from_sq, occupied_bb) | bishop_attacks(from_sq, occupied_bb);
+            break;
+    }
+
+    return moves & ~colors_bb_array[Us];
+}
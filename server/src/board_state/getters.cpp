@@ -1,70 +1,15 @@
 #include "BoardState.h"
 #include <cstdint>
 #include <vector>
+#include <algorithm>
 
-uint64_t BoardState::getAttackersForSq(Color sideToMove, int sq) const{
-    Color oppColor = static_cast<Color>(1 - sideToMove); 
-    int enemy_idx = oppColor * PC_NUM;
-
-    uint64_t attackers = 0ULL;
-
-    // --- Lookup precomputado (simétrico) ---
-    attackers |= (types_bb_array[KING + enemy_idx] & king_lookup[sq]);
-    attackers |= (types_bb_array[KNIGHT + enemy_idx] & knight_lookup[sq]);
-
-    // Pawn attacks - optimized with direct lookup
-    const uint64_t pawnAttackers = types_bb_array[PAWN + enemy_idx];
-    if (oppColor == WHITE) {
-        attackers |= pawnAttackers & black_pawn_attacks_lookup[sq];
-    } else {
-        attackers |= pawnAttackers & white_pawn_attacks_lookup[sq];
-    }
-
-    // --- Deslizadores: alfiles y reinas (diagonales) ---
-    uint64_t bishop_mask = bishop_masks[sq];
-    uint64_t occ_diag = occupied_bb & bishop_mask;
-    uint64_t bishop_magic_index = (occ_diag * BISHOP_MAGICS[sq]) >> bishop_magic_shifts[sq];
-    uint64_t bishop_attacks = bishop_magic_attack_table[bishop_magic_offsets[sq] + bishop_magic_index];
-    attackers |= (bishop_attacks & (types_bb_array[BISHOP + enemy_idx] | types_bb_array[QUEEN + enemy_idx]));
-
-    // --- Torres y reinas (líneas rectas) ---
-    uint64_t rook_mask = rook_masks[sq];
-    uint64_t occ_line = occupied_bb & rook_mask;
-    uint64_t rook_magic_index = (occ_line * ROOK_MAGICS[sq]) >> rook_magic_shifts[sq];
-    uint64_t rook_attacks = rook_magic_attack_table[rook_magic_offsets[sq] + rook_magic_index];;
-    attackers |= (rook_attacks & (types_bb_array[ROOK + enemy_idx] | types_bb_array[QUEEN + enemy_idx]));
-
-    return attackers;
+uint64_t BoardState::getAttackersForSq(Color sideToMove, int sq) const {
+    return sideToMove == WHITE ? attackers_to<WHITE>(sq) : attackers_to<BLACK>(sq);
 }
 
 
 uint64_t BoardState::getLinearThreats(Color sideToMove) const {
-    Piece kingPiece = static_cast<Piece>(KING + sideToMove * PC_NUM); // index of the king
-    uint64_t kingBB = types_bb_array[kingPiece];
-
-    int kingSq = __builtin_ctzll(kingBB); // Posición del rey (asume único rey)
-
-    int oppColor = 1 - sideToMove;  
-    int enemy_idx = oppColor * PC_NUM;
-    uint64_t enemy_bb = colors_bb_array[oppColor];
-
-    uint64_t threats = 0ULL;
-
-    // --- Deslizadores: alfiles y reinas (diagonales) ---
-    uint64_t bishop_mask = bishop_masks[kingSq];
-    uint64_t occ_diag = enemy_bb & bishop_mask;
-    uint64_t bishop_magic_index = (occ_diag * BISHOP_MAGICS[kingSq]) >> bishop_magic_shifts[kingSq];
-    uint64_t bishop_attacks = bishop_magic_attack_table[bishop_magic_offsets[kingSq] + bishop_magic_index];
-    threats |= (bishop_attacks & (types_bb_array[BISHOP + enemy_idx] | types_bb_array[QUEEN + enemy_idx]));
-
-    // --- Torres y reinas (líneas rectas) ---
-    uint64_t rook_mask = rook_masks[kingSq];
-    uint64_t occ_line = enemy_bb & rook_mask;
-    uint64_t rook_magic_index = (occ_line * ROOK_MAGICS[kingSq]) >> rook_magic_shifts[kingSq];
-    uint64_t rook_attacks = rook_magic_attack_table[rook_magic_offsets[kingSq] + rook_magic_index];;
-    threats |= (rook_attacks & (types_bb_array[ROOK + enemy_idx] | types_bb_array[QUEEN + enemy_idx]));
-
-    return threats;
+    return sideToMove == WHITE ? linear_threats<WHITE>() : linear_threats<BLACK>();
 }
 
 
@@ -79,66 +24,73 @@ uint64_t BoardState::getRayBetween(Color sideToMove, int sq) const {
 }
 
 
-uint64_t BoardState::getPseudoLegalMoves(int from_sq) const {
-    Piece pc = piece_at(from_sq); // 0-11
+int BoardState::see(uint16_t move_code) const {
+    int from_sq = (move_code >> 6) & 0x3F;
+    int to_sq = move_code & 0x3F;
+    MoveType move_type = move_kind(move_code);
 
-    uint64_t occupied = occupied_bb;
+    if (move_type == CASTLING) return 0;
 
-    uint64_t friendly = getFriendlyBB(pc);
+    Piece mover = board[from_sq];
+    Color side = colorOf(mover);
 
-    Type type = getType(pc);
+    uint64_t occupancy = occupied_bb ^ (1ULL << from_sq);
+    int gain[32];
 
-    uint64_t moves = 0;
+    // Valor de lo capturado en el primer movimiento y de la pieza que queda en la casilla
+    gain[0] = board[to_sq] == NO_PIECE ? 0 : PIECE_BASE_VALUE[getType(board[to_sq])];
+    int on_square = PIECE_BASE_VALUE[getType(mover)];
 
-    switch (type) {
-        case KNIGHT:
-            moves = knight_lookup[from_sq];
-            break;
-        case KING:
-            moves = king_lookup[from_sq];
-            break;
-        case PAWN: {
-            uint64_t p_moves = (colorOf(pc) ? white_pawn_moves_lookup[from_sq] : black_pawn_moves_lookup[from_sq]) & ~occupied;
-            uint64_t p_attacks = (colorOf(pc) ? white_pawn_attacks_lookup[from_sq] : black_pawn_attacks_lookup[from_sq]) & occupied;
+    if (move_type == EN_PASSANT) {
+        occupancy ^= 1ULL << (side == WHITE ? to_sq - 8 : to_sq + 8);
+        gain[0] = PIECE_BASE_VALUE[PAWN];
+    } else if (move_type == PROMOTION || move_type == PROMOTION_CAPTURE) {
+        gain[0] += PIECE_BASE_VALUE[promotion_piece(move_code)] - PIECE_BASE_VALUE[PAWN];
+        on_square = PIECE_BASE_VALUE[promotion_piece(move_code)];
+    }
 
-            // Obstáculo directo frente al peón
-            if ((pc == WHITE_PAWN && (occupied >> (from_sq + 8)) & 1) ||
-                (pc == BLACK_PAWN && (occupied >> (from_sq - 8)) & 1)) {
-                p_moves = 0;
+    uint64_t diagonal = types_bb_array[WHITE_BISHOP] | types_bb_array[WHITE_QUEEN]
+                      | types_bb_array[BLACK_BISHOP] | types_bb_array[BLACK_QUEEN];
+    uint64_t straight = types_bb_array[WHITE_ROOK] | types_bb_array[WHITE_QUEEN]
+                      | types_bb_array[BLACK_ROOK] | types_bb_array[BLACK_QUEEN];
+
+    uint64_t attackers = all_attackers_to(to_sq, occupancy) & occupancy;
+
+    // De menor a mayor valor: siempre se recaptura con la pieza más barata
+    static constexpr std::array<Type, 6> by_value = {PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING};
+
+    int depth = 0;
+    while (depth < 31) {
+        side = static_cast<Color>(1 - side);
+        uint64_t own_attackers = attackers & colors_bb_array[side];
+        if (!own_attackers) break;
+
+        uint64_t attacker_bb = 0;
+        Type attacker_type = KING;
+        for (Type type : by_value) {
+            attacker_bb = own_attackers & types_bb_array[type + side * PC_NUM];
+            if (attacker_bb) {
+                attacker_type = type;
+                break;
             }
-
-            moves = p_moves | p_attacks;
-            break;
-        }
-        case ROOK: {
-            uint64_t mask = rook_masks[from_sq];
-            uint64_t occupied_mask = occupied & mask;
-            uint64_t magic_index = (occupied_mask * ROOK_MAGICS[from_sq]) >> rook_magic_shifts[from_sq];
-            moves = rook_magic_attack_table[rook_magic_offsets[from_sq] + magic_index];
-            break;
-        }
-        case BISHOP: {
-            uint64_t mask = bishop_masks[from_sq];
-            uint64_t occupied_mask = occupied & mask;
-            uint64_t magic_index = (occupied_mask * BISHOP_MAGICS[from_sq]) >> bishop_magic_shifts[from_sq];
-            moves = bishop_magic_attack_table[bishop_magic_offsets[from_sq] + magic_index];
-            break;
-        }
-        case QUEEN: {
-            uint64_t rook_mask = rook_masks[from_sq];
-            uint64_t occupied_for_rook = occupied & rook_mask;
-            uint64_t rook_magic_index = (occupied_for_rook * ROOK_MAGICS[from_sq]) >> rook_magic_shifts[from_sq];
-            uint64_t rook_moves = rook_magic_attack_table[rook_magic_offsets[from_sq] + rook_magic_index];
-
-            uint64_t bishop_mask = bishop_masks[from_sq];
-            uint64_t occupied_for_bishop = occupied & bishop_mask;
-            uint64_t bishop_magic_index = (occupied_for_bishop * BISHOP_MAGICS[from_sq]) >> bishop_magic_shifts[from_sq];
-            uint64_t bishop_moves = bishop_magic_attack_table[bishop_magic_offsets[from_sq] + bishop_magic_index];
-
-            moves = rook_moves | bishop_moves;
-            break;
         }
+
+        ++depth;
+        gain[depth] = on_square - gain[depth - 1];
+
+        // Quitar al atacante destapa a los deslizadores que tenía detrás
+        occupancy ^= attacker_bb & -attacker_bb;
+        attackers |= (bishop_attacks(to_sq, occupancy) & diagonal) | (rook_attacks(to_sq, occupancy) & straight);
+        attackers &= occupancy;
+
+        on_square = PIECE_BASE_VALUE[attacker_type];
     }
 
-    return moves & ~friendly;
-};
+    // Cada bando elige entre recapturar o quedarse con lo que tiene
+    while (depth > 0) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        --depth;
+    }
+
+    return gain[0];
+}
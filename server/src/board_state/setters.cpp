@@ -9,6 +9,47 @@ void BoardState::setStartPosition() {
     types_bb_array = INITIAL_PIECE_BITBOARDS;
     occupied_bb = INITIAL_OCCUPANCY_ALL;
     colors_bb_array = INITIAL_OCCUPANCY_BY_COLOR;
+
+    hash_key = 0ULL;
+    psq_score = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        if (board[sq] == NO_PIECE) continue;
+        hash_key ^= ZOBRIST.pieces[board[sq]][sq];
+        psq_score += PIECE_SQUARE_SCORE[board[sq]][sq];
+    }
+}
+
+bool BoardState::setFromFen(const std::string& placement) {
+    board.fill(NO_PIECE);
+    types_bb_array.fill(0ULL);
+    colors_bb_array.fill(0ULL);
+    occupied_bb = 0ULL;
+    hash_key = 0ULL;
+    psq_score = 0;
+
+    // FEN starts at rank 8, file a
+    int rank = 7, file = 0;
+
+    for (char c : placement) {
+        if (c == '/') {
+            if (file != 8 || rank == 0) return false;
+            rank--;
+            file = 0;
+        } else if (c >= '1' && c <= '8') {
+            file += c - '0';
+            if (file > 8) return false;
+        } else {
+            Piece pc = piece_from_fen_char(c);
+            if (pc == NO_PIECE || file > 7) return false;
+            addPiece(rank * 8 + file, pc);
+            file++;
+        }
+    }
+
+    // Exactly one king per side
+    return rank == 0 && file == 8 &&
+           __builtin_popcountll(types_bb_array[WHITE_KING]) == 1 &&
+           __builtin_popcountll(types_bb_array[BLACK_KING]) == 1;
 }
 
 void BoardState::movePiece(int fromSq, int toSq) {
@@ -27,6 +68,9 @@ void BoardState::movePiece(int fromSq, int toSq) {
     
     // Update occupancy: clear from, set to
     occupied_bb ^= moveMask;
+
+    hash_key ^= ZOBRIST.pieces[pc][fromSq] ^ ZOBRIST.pieces[pc][toSq];
+    psq_score += PIECE_SQUARE_SCORE[pc][toSq] - PIECE_SQUARE_SCORE[pc][fromSq];
     
     // Update mailbox
     board[fromSq] = NO_PIECE;
@@ -50,6 +94,9 @@ void BoardState::addPiece(int sq, Piece pc) {
     types_bb_array[pc] |= mask;
     colors_bb_array[color] |= mask;
     occupied_bb |= mask;
+
+    hash_key ^= ZOBRIST.pieces[pc][sq];
+    psq_score += PIECE_SQUARE_SCORE[pc][sq];
     
     // Update mailbox
     board[sq] = pc;
@@ -72,6 +119,9 @@ Piece BoardState::deletePiece(int sq) {
     types_bb_array[pc] &= ~mask;
     colors_bb_array[color] &= ~mask;
     occupied_bb &= ~mask;
+
+    hash_key ^= ZOBRIST.pieces[pc][sq];
+    psq_score -= PIECE_SQUARE_SCORE[pc][sq];
     
     // Update mailbox
     board[sq] = NO_PIECE;
@@ -97,19 +147,3 @@ void BoardState::castling(int from_sq, int to_sq, bool reverse) {
         movePiece(rook_from, rook_to);
     }
 }
-
-
-Piece BoardState::promote(int promotion_sq, Type promotion) { // promotes to queen by default
-    Piece pc = piece_at(promotion_sq);
-    Type type = getType(pc);
-    Color color = colorOf(pc);
-
-    if (type != PAWN || !((PROMOTION_ROWS[color] >> promotion_sq) & 1ULL)) return NO_PIECE;
-
-    deletePiece(promotion_sq);
-
-    Piece promotion_pc = static_cast<Piece>(color * PC_NUM + promotion);
-    addPiece(promotion_sq, promotion_pc);
-
-    return promotion_pc;
-}
\ No newline at end of file
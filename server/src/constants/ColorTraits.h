@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "Types.h"
+#include "StaticData.h"
+#include "../precomputed_moves/non_sliding_moves/data.h"
+
+// Desplaza un bitboard D casillas, positivo hacia la fila 8
+template <int D>
+constexpr uint64_t shift(uint64_t bb) noexcept {
+    return D > 0 ? bb << D : bb >> -D;
+}
+
+// Constantes por color para el generador con plantilla: con template<Color Us>
+// cada rama sobre el bando que mueve se resuelve en compilación
+template <Color Us>
+struct ColorTraits {
+    static constexpr Color them = Us == WHITE ? BLACK : WHITE;
+    static constexpr int own_offset = Us * PC_NUM;      // primera Piece de este color
+    static constexpr int enemy_offset = them * PC_NUM;
+    static constexpr int push = Us == WHITE ? 8 : -8;   // un paso de peón hacia adelante
+    static constexpr int capture_west = push - 1;       // captura hacia la columna a
+    static constexpr int capture_east = push + 1;       // captura hacia la columna h
+
+    static constexpr uint64_t promotion_row = PROMOTION_ROWS[Us];
+    // Fila a la que llega un avance simple desde la fila inicial: solo desde ella hay doble avance
+    static constexpr uint64_t double_push_row = Us == WHITE ? 0x0000000000FF0000ULL : 0x0000FF0000000000ULL;
+
+    // Enroque: derechos del bando y casillas iniciales de sus torres
+    static constexpr uint8_t castling_rights = Us == WHITE ? 0b0011U : 0b1100U;
+    static constexpr int queen_rook_sq = Us == WHITE ? 0 : 56;
+    static constexpr int king_rook_sq = Us == WHITE ? 7 : 63;
+
+    static const std::array<uint64_t, 64>& pawn_pushes() {
+        if constexpr (Us == WHITE) return white_pawn_moves_lookup;
+        else return black_pawn_moves_lookup;
+    }
+
+    // Casillas que un peón de este color ataca desde sq; leída al revés, los
+    // peones enemigos que atacan sq
+    static const std::array<uint64_t, 64>& pawn_attacks() {
+        if constexpr (Us == WHITE) return white_pawn_attacks_lookup;
+        else return black_pawn_attacks_lookup;
+    }
+};
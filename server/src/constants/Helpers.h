@@ -4,4 +4,10 @@
 
 RookMoveData get_castling_rook_move(int king_from, int king_to);
 
-std::array<int, 2> getCastlingPath(int rook_square);
\ No newline at end of file
+std::array<int, 2> getCastlingPath(int rook_square);
+
+// FEN / UCI text helpers
+Piece piece_from_fen_char(char c);
+std::string square_to_string(int sq);
+int square_from_string(const std::string& str);
+std::string move_to_string(uint16_t move_code);
\ No newline at end of file
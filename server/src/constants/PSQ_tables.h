@@ -181,4 +181,24 @@ inline const std::array<int, 64>& get_table_by_piece(Piece pc) {
 }
 
 
+// --- Material + PSQ por pieza y casilla, con signo (blancas suman, negras restan) ---
+// BoardState lo acumula incrementalmente, la evaluación de una hoja es una lectura.
+constexpr std::array<std::array<int, 64>, 12> PIECE_SQUARE_SCORE = [] {
+    std::array<std::array<int, 64>, 12> table{};
+    constexpr std::array<const std::array<int, 64>*, 12> psq = {
+        &BLACK_BISHOP_PSQ, &BLACK_KING_PSQ, &BLACK_KNIGHT_PSQ,
+        &BLACK_PAWN_PSQ, &BLACK_QUEEN_PSQ, &BLACK_ROOK_PSQ,
+        &BISHOP_PSQ, &KING_PSQ, &KNIGHT_PSQ,
+        &PAWN_PSQ, &QUEEN_PSQ, &ROOK_PSQ
+    };
+    for (int pc = 0; pc < 12; ++pc) {
+        int sign = pc < 6 ? -1 : 1;
+        for (int sq = 0; sq < 64; ++sq) {
+            table[pc][sq] = sign * (PIECE_BASE_VALUE[pc % 6] + (*psq[pc])[sq]);
+        }
+    }
+    return table;
+}();
+
+
 #endif // PSQ_TABLES_H
\ No newline at end of file
@@ -4,7 +4,5 @@
 #include <cstdint>
 #include <cstdlib>
 
-// Precomputed ray lookup tables - initialize once at startup
-extern std::array<std::array<uint64_t, 64>, 64> ray_between_table;
-
-void init_ray_tables();
\ No newline at end of file
+// Precomputed ray lookup tables - built at compile time, read-only
+extern const std::array<std::array<uint64_t, 64>, 64> ray_between_table;
@@ -33,6 +33,10 @@ constexpr uint64_t WHITE_EN_PASSANT_TRACK = 0x000000FF00000000ULL; // Fila 4 par
 constexpr uint64_t BLACK_EN_PASSANT_TRACK = 0x00000000FF000000ULL; // Fila 5 para peones negros
 
 
+// Columnas de los bordes, para que los desplazamientos de peones no den la vuelta al tablero
+constexpr uint64_t FILE_A_BB = 0x0101010101010101ULL;
+constexpr uint64_t FILE_H_BB = 0x8080808080808080ULL;
+
 // Bitboards para saber si un peón está promoviendo
 constexpr std::array<uint64_t, 2> PROMOTION_ROWS = {
     0b0000000000000000000000000000000000000000000000000000000011111111ULL,
@@ -68,12 +72,26 @@ constexpr std::array<Piece, 64> INITIAL_MAILBOX_BOARD = {
 };
 
 constexpr std::array<const char*, 5> eventMessages = {
-    "none", "check", "checkmate", "stalemate", "promotion"
+    "none", "check", "checkmate", "stalemate", "draw"
 };
 
-constexpr int MAX_DEPTH = 5; // This is the max secure depth by now
-constexpr int MAX_MOVES = 28; // This number is an ideal case: queen in the middle of an empty board
+constexpr int MAX_DEPTH = 5; // Default depth for enginego without a time or node budget
+constexpr int MAX_PLY = 64;   // Hard limit for search depth, sizes the undo stack
+constexpr int GAME_HISTORY_SIZE = 128; // Keys of the last game moves, covers the fifty-move window
+
 
+// Derechos de enroque que sobreviven a un movimiento que toca cada casilla (origen o destino)
+constexpr std::array<uint8_t, 64> CASTLING_RIGHTS_MASK = [] {
+    std::array<uint8_t, 64> mask{};
+    mask.fill(0b1111U);
+    mask[SQ_A1] = 0b1110U;
+    mask[SQ_H1] = 0b1101U;
+    mask[SQ_E1] = 0b1100U;
+    mask[SQ_A8] = 0b1011U;
+    mask[SQ_H8] = 0b0111U;
+    mask[SQ_E8] = 0b0011U;
+    return mask;
+}();
 
 inline int getCastlingIdx(int rook_square) {
     switch (rook_square) {
@@ -87,4 +105,12 @@ inline int getCastlingIdx(int rook_square) {
 
 constexpr int CHECK_BONUS = 1000;
 constexpr int CHECKMATE_BONUS = 10000;
+constexpr int DELTA_MARGIN = 200; // Quiescence delta pruning safety margin
+constexpr int ASPIRATION_WINDOW = 25; // Initial half-width around the previous iteration's score
+constexpr int ASPIRATION_DEPTH = 4;   // Shallower iterations use the full window
+constexpr int NULL_MOVE_MIN_DEPTH = 3; // Null-move pruning only with this much depth left
+constexpr int LMR_MIN_DEPTH = 3;       // Late move reductions only with this much depth left
+constexpr int LMR_MIN_MOVES = 3;       // Moves searched at full depth before reducing
+constexpr int MOVE_OVERHEAD_MS = 30;   // Clock kept in reserve for I/O latency
+constexpr int DEFAULT_MOVES_TO_GO = 30; // Moves the remaining clock is split over without movestogo
 
@@ -1,6 +1,7 @@
 // PieceType.h
 
 #pragma once
+#include <cassert>
 #include <cstdint>
 #include <array>
 #include <string>
@@ -60,26 +61,95 @@ enum GameEvent : uint8_t {
     CHECK = 1,
     CHECKMATE = 2,
     STALEMATE = 3,
-    PROMOTION_EVENT = 4,
+    DRAW = 4,        // fifty-move rule or threefold repetition
 };
 
+// Los 4 bits altos del código de movimiento. En las promociones el bit 3 las marca,
+// el bit 2 indica captura y los bits 0-1 la pieza elegida (PROMOTION_PIECES), así
+// PROMOTION | 3 es coronar a dama y PROMOTION_CAPTURE | 0 capturar coronando a caballo
 enum MoveType : uint8_t {
     MOVE = 0,
     CAPTURE = 1,
     CASTLING = 2,
     EN_PASSANT = 3,
-    PROMOTION = 4,
-    PROMOTION_CAPTURE = 5,
+    PROMOTION = 8,
+    PROMOTION_CAPTURE = 12,
 };
 
+constexpr std::array<Type, 4> PROMOTION_PIECES = {KNIGHT, BISHOP, ROOK, QUEEN};
+constexpr std::array<char, 4> PROMOTION_CHARS = {'n', 'b', 'r', 'q'}; // sufijo UCI
+
+// Tipo de un código de movimiento, con las promociones sin la pieza (PROMOTION o PROMOTION_CAPTURE)
+inline MoveType move_kind(uint16_t move_code) {
+    uint8_t type = move_code >> 12;
+    return static_cast<MoveType>(type & PROMOTION ? type & 0b1100U : type);
+}
+
+inline bool is_promotion(uint16_t move_code) {
+    return (move_code >> 12) & PROMOTION;
+}
+
+inline Type promotion_piece(uint16_t move_code) {
+    return PROMOTION_PIECES[(move_code >> 12) & 0b11U];
+}
+
+inline char promotion_char(uint16_t move_code) {
+    return PROMOTION_CHARS[(move_code >> 12) & 0b11U];
+}
+
+// Código completo de una promoción: kind es PROMOTION o PROMOTION_CAPTURE, index la posición en PROMOTION_PIECES
+inline uint16_t promotion_move(MoveType kind, int index, int from_sq, int to_sq) {
+    return static_cast<uint16_t>(((kind | index) << 12) | (from_sq << 6) | to_sq);
+}
+
 struct UndoInfo {
-    uint16_t move_code;  // static_cast<uint16_t>((from_sq << 6) | to_sq);
+    uint16_t move_code;  // (type << 12) | (from_sq << 6) | to_sq, type includes the promotion piece
     Piece captured_piece;
     int8_t prev_en_passant_sq;
     uint8_t prev_castling_rights;
+    uint16_t prev_halfmove_clock;
+    uint64_t prev_key;   // Position before the move, read back by the repetition check
+};
+
+// Check and pin data of one node, computed the first time the node needs it
+struct PositionInfo {
+    uint64_t key;         // Position the record belongs to, a stale record never matches
+    uint64_t checkers;    // Enemy pieces giving check
+    uint64_t pinned;      // Own pieces pinned to the king
+    uint64_t check_mask;  // Squares that answer a single check, ~0 without check, 0 in double check
 };
 
 
+// Lista de movimientos en la pila, sin reservas de memoria en la búsqueda
+constexpr int MAX_LEGAL_MOVES = 256; // El máximo legal conocido es 218
+
+// Bounds are checked with assert, so only builds without NDEBUG (make DEBUG=1) pay for it
+struct MoveList {
+    std::array<uint16_t, MAX_LEGAL_MOVES> moves;
+    int count = 0;
+
+    inline void push(uint16_t move_code) noexcept {
+        assert(count < MAX_LEGAL_MOVES && "MoveList overflow");
+        moves[count++] = move_code;
+    }
+    inline void clear() noexcept { count = 0; }
+    inline int size() const noexcept { return count; }
+
+    inline uint16_t& operator[](int i) noexcept {
+        assert(i >= 0 && i < count && "MoveList index out of range");
+        return moves[i];
+    }
+    inline uint16_t operator[](int i) const noexcept {
+        assert(i >= 0 && i < count && "MoveList index out of range");
+        return moves[i];
+    }
+
+    inline uint16_t* begin() noexcept { return moves.data(); }
+    inline uint16_t* end() noexcept { return moves.data() + count; }
+    inline const uint16_t* begin() const noexcept { return moves.data(); }
+    inline const uint16_t* end() const noexcept { return moves.data() + count; }
+};
+
 struct MoveStream {
     int from_sq_1;
     int to_sq_1;
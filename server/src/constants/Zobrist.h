@@ -0,0 +1,43 @@
+// Zobrist.h
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Claves Zobrist generadas en tiempo de compilación con una semilla fija,
+// así todas las instancias del motor producen las mismas claves.
+namespace zobrist_detail {
+    constexpr uint64_t splitmix64(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    struct ZobristKeys {
+        std::array<std::array<uint64_t, 64>, 12> pieces{};  // [Piece][sq]
+        std::array<uint64_t, 16> castling{};                // [castling_rights]
+        std::array<uint64_t, 8> en_passant{};               // [file]
+        uint64_t side = 0;                                  // Negras mueven
+    };
+
+    constexpr ZobristKeys generate_keys() {
+        ZobristKeys keys;
+        uint64_t state = 0x4B696E67736C6179ULL; // "Kingslay"
+
+        for (auto& piece_keys : keys.pieces) {
+            for (auto& key : piece_keys) key = splitmix64(state);
+        }
+        for (auto& key : keys.castling) key = splitmix64(state);
+        for (auto& key : keys.en_passant) key = splitmix64(state);
+        keys.side = splitmix64(state);
+
+        return keys;
+    }
+}
+
+inline constexpr zobrist_detail::ZobristKeys ZOBRIST = zobrist_detail::generate_keys();
+
+inline constexpr uint64_t zobrist_en_passant_key(int8_t ep_sq) {
+    return ep_sq < 0 ? 0ULL : ZOBRIST.en_passant[ep_sq % 8];
+}
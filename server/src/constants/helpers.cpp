@@ -33,4 +33,45 @@ std::array<int, 2> getCastlingPath(int rook_square) {
         case 63: return {61, 62}; // Torre en 63 para flanco de rey negro
     }
     return {NO_SQ, NO_SQ};
+}
+
+
+Piece piece_from_fen_char(char c) {
+    switch (c) {
+        case 'b': return BLACK_BISHOP;
+        case 'k': return BLACK_KING;
+        case 'n': return BLACK_KNIGHT;
+        case 'p': return BLACK_PAWN;
+        case 'q': return BLACK_QUEEN;
+        case 'r': return BLACK_ROOK;
+        case 'B': return WHITE_BISHOP;
+        case 'K': return WHITE_KING;
+        case 'N': return WHITE_KNIGHT;
+        case 'P': return WHITE_PAWN;
+        case 'Q': return WHITE_QUEEN;
+        case 'R': return WHITE_ROOK;
+    }
+    return NO_PIECE;
+}
+
+
+std::string square_to_string(int sq) {
+    if (sq < 0 || sq > 63) return "-";
+    return {static_cast<char>('a' + sq % 8), static_cast<char>('1' + sq / 8)};
+}
+
+
+int square_from_string(const std::string& str) {
+    if (str.size() != 2 || str[0] < 'a' || str[0] > 'h' || str[1] < '1' || str[1] > '8') return NO_SQ;
+    return (str[1] - '1') * 8 + (str[0] - 'a');
+}
+
+
+// Coordinate notation, e.g. "e2e4" or "e7e8q"
+std::string move_to_string(uint16_t move_code) {
+    int from_sq = (move_code >> 6) & 0b111111U;
+    int to_sq = move_code & 0b111111U;
+    std::string move_str = square_to_string(from_sq) + square_to_string(to_sq);
+    if (is_promotion(move_code)) move_str += promotion_char(move_code);
+    return move_str;
 }
\ No newline at end of file
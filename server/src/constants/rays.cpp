@@ -1,10 +1,9 @@
 #include "Rays.h"
-#include <iostream>
 
-std::array<std::array<uint64_t, 64>, 64> ray_between_table;
+// Precompute rays between all square pairs, evaluated by the compiler
+constexpr std::array<std::array<uint64_t, 64>, 64> ray_between_table = [] {
+    std::array<std::array<uint64_t, 64>, 64> table{};
 
-void init_ray_tables() {
-    // Precompute rays between all square pairs
     for (int sq1 = 0; sq1 < 64; ++sq1) {
         for (int sq2 = 0; sq2 < 64; ++sq2) {
             if (sq1 == sq2) continue;
@@ -18,7 +17,7 @@ void init_ray_tables() {
             
             // Only compute if aligned
             if (dr == 0 && df == 0) continue; // Same square
-            if (dr != 0 && df != 0 && abs(r2 - r1) != abs(f2 - f1)) continue; // Not diagonal
+            if (dr != 0 && df != 0 && (r2 - r1) * dr != (f2 - f1) * df) continue; // Not diagonal
             
             uint64_t ray = 0ULL;
             const int step = dr * 8 + df;
@@ -27,7 +26,9 @@ void init_ray_tables() {
                 ray |= 1ULL << sq;
             }
             
-            ray_between_table[sq1][sq2] = ray;
+            table[sq1][sq2] = ray;
         }
     }
-}
+
+    return table;
+}();
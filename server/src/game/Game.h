@@ -17,44 +17,45 @@ private:
     BoardState board_state;
     uint8_t castling_rights;
     int8_t en_passant_sq;
-    int8_t promotion_sq;
     Color sideToMove;
     GameEvent game_event;
     int ply;                     // Current search depth / move counter
+    uint16_t halfmove_clock;     // Plies since the last capture or pawn move
+    int fullmove_number;         // Starts at 1, incremented after Black moves
 
     // =========================
     // SEARCH & MOVE DATA
     // =========================
-    std::array<uint64_t, 64> pinned_rays;           // Ray for pinned pieces, 0 if not pinned
-    std::array<UndoInfo, MAX_DEPTH> undo_stack;     // Stack for move undo information
-   
-    // three arrays to store different priority moves
-    std::array<uint16_t, 8> high_priority_moves;
-    std::array<uint16_t, 8> medium_priority_moves;  
-    std::array<uint16_t, 24> low_priority_moves; 
-
-    int high_priority_count, medium_priority_count, low_priority_count;
+    std::array<UndoInfo, MAX_PLY> undo_stack;       // Stack for move undo information
+    std::array<PositionInfo, MAX_PLY> info_stack;   // Checkers and pins per ply, survive unmake_move
+    std::array<uint64_t, GAME_HISTORY_SIZE> game_history; // Keys before each game move, a ring indexed by game_moves
+    int game_moves;                                 // Moves made with make_game_move
+#ifdef COPY_MAKE
+    std::array<BoardState, MAX_PLY> board_stack;    // Board before each move, unmake_move copies it back
+#endif
 
     // =========================
     // MOVE GENERATION HELPERS
     // =========================
-    uint64_t get_en_passant_bb(int sq) const;
-    std::array<uint16_t, 2> get_castling_move(int king_sq) const;
-    void set_pinned_pieces();
+    template <Color Us> std::array<uint16_t, 2> get_castling_move(int king_sq) const;
+    const PositionInfo& position_info();
     
-    // Legal move generation helpers
+    // Legal move generation helpers, templated on the side to move (dispatched once per node)
     uint64_t calculate_allowed_moves_in_check(uint64_t king_attackers, int num_attackers);
-    bool is_legal_move(int from_sq, int to_sq, Piece piece, int king_sq,
-                       int num_attackers, uint64_t allowed_moves, uint64_t enemy_bb);
-    MoveType get_move_type(int from_sq, int to_sq, Piece piece, uint64_t enemy_bb, uint64_t to_sq_bb);
-    void add_castling_moves(int from_sq);
-    bool would_be_check(uint16_t move_code);
-    void prioritize_and_store_move(uint16_t move_code);
+    template <Color Us>
+    bool is_legal_move(int from_sq, int to_sq, Type piece_type, int king_sq, const PositionInfo& info);
+    template <Color Us> bool is_legal_en_passant(int from_sq, int to_sq, int king_sq);
+    template <Color Us> bool is_legal(uint16_t move_code);
+    template <Color Us> MoveType get_move_type(uint64_t to_sq_bb);
+    void generate_legal(MoveList& move_list, bool captures_only);
+    template <Color Us> void generate_legal(MoveList& move_list, bool captures_only);
+    template <Color Us>
+    void generate_pawn_moves(MoveList& move_list, bool captures_only, int king_sq, const PositionInfo& info);
 
     // =========================
     // GAME STATE MANAGEMENT
     // =========================
-    void update_castling_rights(int to_sq);
+    void update_castling_rights(int from_sq, int to_sq);
 
 public:
     // =========================
@@ -63,46 +64,65 @@ public:
     Game() 
         : castling_rights(INITIAL_CASTLING_RIGHTS)
         , en_passant_sq(NO_SQ)
-        , promotion_sq(NO_SQ)
         , sideToMove(WHITE)
         , game_event(NONE)
         , ply(0)
+        , halfmove_clock(0)
+        , fullmove_number(1)
+        , game_moves(0)
     {
         board_state = BoardState();
-        pinned_rays.fill(0ULL);
+        board_state.xor_key(ZOBRIST.castling[castling_rights]);
+        info_stack.fill(PositionInfo{});
     }
 
+    bool set_fen(const std::string& fen);
+    uint16_t find_move(const std::string& move_str);   // coordinate notation, 0 if illegal
+
     // =========================
     // BASIC GAME CONTROL
     // =========================
-    inline void changeTurn() noexcept { sideToMove = Color(1 - sideToMove); }
+    inline void changeTurn() noexcept {
+        sideToMove = Color(1 - sideToMove);
+        board_state.xor_key(ZOBRIST.side);
+    }
     inline void increase_ply() noexcept { ply++; }
     inline void decrease_ply() noexcept { ply--; }
-    inline BoardState get_board_state() const noexcept { return board_state; }
+    inline const BoardState& get_board_state() const noexcept { return board_state; }
     inline GameEvent get_game_event() const noexcept { return game_event; }
     inline Color get_side_to_move() const noexcept { return sideToMove; }
-    inline int get_promotion_sq() const noexcept { return promotion_sq; }
-    inline void set_promotion_sq(int8_t sq) noexcept { promotion_sq = sq; }
+    inline uint64_t get_key() const noexcept { return board_state.key(); }
+    inline int get_ply() const noexcept { return ply; }
+    inline int get_halfmove_clock() const noexcept { return halfmove_clock; }
+    inline int get_fullmove_number() const noexcept { return fullmove_number; }
 
     // =========================
     // MOVE GENERATION & EXECUTION
     // =========================
-    std::vector<uint16_t> get_legal_moves(int sq);
-    void stream_move_data(uint16_t move_code);
+    void get_legal_moves(int sq, MoveList& move_list, std::ostream& out = std::cout);
+    void generate_all_legal(MoveList& move_list);
+    void generate_captures(MoveList& move_list);
+    bool is_legal(uint16_t move_code);
+    void stream_move_data(uint16_t move_code, std::ostream& out = std::cout);
     void make_move(uint16_t move_code);
     void unmake_move();
+    void make_game_move(uint16_t move_code); // a move of the game itself, never unmade
+    void make_null_move();   // pass the turn, the caller still calls changeTurn like after make_move
+    void unmake_null_move();
 
     // =========================
     // GAME STATE ANALYSIS
     // =========================
     uint64_t detect_check();
+    bool in_check();
     bool detect_game_over();
+    bool is_draw();          // fifty-move rule or repetition, see events.cpp
 
     // =========================P
     // USER INTERFACE METHODS
     // =========================
-    void user_moves(uint16_t move_code);
-    void user_promotion(int promotion);
+    void user_moves(uint16_t move_code, std::ostream& out = std::cout);
+    void play_move(uint16_t move_code); // silent, used by "position"
 };
 
 #endif
\ No newline at end of file
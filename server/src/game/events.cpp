@@ -1,4 +1,5 @@
 #include "Game.h"
+#include <algorithm>
 
 // These funcions can be used only right after a move takes place
 
@@ -19,41 +20,55 @@ uint64_t Game::detect_check() {
     return threats;
 }
 
-// Verifies if last enemy move ended the game, only called when check was previously detected
-bool Game::detect_game_over() {
-    if (game_event != CHECK) return false;
+// Same as detect_check but without touching game_event, safe to call inside search.
+// Fills the node's position info, so the move generation that follows reuses it
+bool Game::in_check() {
+    return position_info().checkers != 0;
+}
 
-    uint64_t king_bb = board_state.king(sideToMove);
-    int king_sq = __builtin_ctzll(king_bb);
+// Verifies if last enemy move ended the game, call it after detect_check
+bool Game::detect_game_over() {
+    MoveList move_list;
+    generate_all_legal(move_list);
 
-    uint64_t threats = board_state.getAttackersForSq(sideToMove, king_sq);
-    bool double_check = (__builtin_popcountll(threats) >= 2);
-
-    if (double_check) {
-        std::vector<uint16_t> movesVector = get_legal_moves(king_sq);
-        if (!movesVector.empty()) {
-            return false; // No checkmate
-        }   
-        game_event = CHECKMATE; // double-check with no escape
+    if (move_list.size() == 0) {
+        // King is in check (checkmate) or not (stalemate), and no legal moves for any piece
+        game_event = game_event == CHECK ? CHECKMATE : STALEMATE;
         return true;
     }
 
-    uint64_t friendly_bb = board_state.color_bb(sideToMove);
+    if (is_draw()) {
+        game_event = DRAW;
+        return true;
+    }
+    return false;
+}
 
-    while (friendly_bb) {
-        int sq = __builtin_ctzll(friendly_bb);
-        friendly_bb &= friendly_bb - 1;
-        
-        std::vector<uint16_t> movesVector = get_legal_moves(sq);
-        if (!movesVector.empty()) {
-            return false; // No checkmate
-        }
+// Fifty-move rule or repetition. Only positions since the last capture or pawn move can
+// repeat (halfmove_clock of them) and only every other one has the same side to move.
+// A position reached inside the search (the last ply entries) counts as a draw on its
+// first repetition, earlier game positions need to appear twice (threefold repetition).
+// A mate given on the move that reaches the fifty-move limit is still a mate
+bool Game::is_draw() {
+    if (halfmove_clock >= 100) {
+        if (!in_check()) return true;
+        MoveList evasions;
+        generate_all_legal(evasions);
+        return evasions.size() != 0;
     }
-    
-    if (threats > 0) {
-        game_event = CHECKMATE; // King is in check and no legal moves for any piece
-    } else {
-        game_event = STALEMATE; // King is not in check, but no legal moves for any piece
+
+    // Earlier positions: the search line on the undo stack, then the game moves before the root
+    int stored = ply + std::min(game_moves, GAME_HISTORY_SIZE);
+    int limit = std::min<int>(halfmove_clock, stored);
+    uint64_t key = board_state.key();
+    int repetitions = 0;
+
+    for (int back = 2; back <= limit; back += 2) {
+        uint64_t earlier = back <= ply
+            ? undo_stack[ply - back].prev_key
+            : game_history[(game_moves - (back - ply)) % GAME_HISTORY_SIZE];
+        if (earlier != key) continue;
+        if (back <= ply || ++repetitions == 2) return true;
     }
-    return true;
+    return false;
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "Game.h"
+#include <sstream>
+
+// Loads a position from FEN, the game is left untouched if the string is invalid
+bool Game::set_fen(const std::string& fen) {
+    std::istringstream iss(fen);
+    std::string placement, side, castling, en_passant;
+    int halfmove = 0, fullmove = 1;
+    iss >> placement >> side >> castling >> en_passant;
+
+    // Clocks are optional, many tools omit them
+    if (!(iss >> halfmove)) halfmove = 0;
+    if (!(iss >> fullmove)) fullmove = 1;
+    if (halfmove < 0 || fullmove < 1) return false;
+
+    Game parsed;
+    if (!parsed.board_state.setFromFen(placement)) return false;
+
+    // Side to move
+    if (side == "w") parsed.sideToMove = WHITE;
+    else if (side == "b") parsed.sideToMove = BLACK;
+    else return false;
+
+    // Castling rights, same bit layout as getCastlingIdx
+    parsed.castling_rights = 0;
+    if (castling != "-") {
+        for (char c : castling) {
+            switch (c) {
+                case 'Q': parsed.castling_rights |= 1U << getCastlingIdx(SQ_A1); break;
+                case 'K': parsed.castling_rights |= 1U << getCastlingIdx(SQ_H1); break;
+                case 'q': parsed.castling_rights |= 1U << getCastlingIdx(SQ_A8); break;
+                case 'k': parsed.castling_rights |= 1U << getCastlingIdx(SQ_H8); break;
+                default: return false;
+            }
+        }
+    }
+
+    // Drop rights whose king or rook is not on its home square
+    const std::array<int, 4> rook_homes = {SQ_A1, SQ_H1, SQ_A8, SQ_H8};
+    for (int rook_sq : rook_homes) {
+        Color color = rook_sq < 8 ? WHITE : BLACK;
+        int king_home = color == WHITE ? SQ_E1 : SQ_E8;
+        Piece rook = static_cast<Piece>(ROOK + color * PC_NUM);
+        Piece king = static_cast<Piece>(KING + color * PC_NUM);
+
+        if (parsed.board_state.piece_at(rook_sq) != rook || parsed.board_state.piece_at(king_home) != king) {
+            parsed.castling_rights &= ~(1U << getCastlingIdx(rook_sq));
+        }
+    }
+
+    // En passant target square
+    parsed.en_passant_sq = NO_SQ;
+    if (!en_passant.empty() && en_passant != "-") {
+        int ep_sq = square_from_string(en_passant);
+        if (ep_sq == NO_SQ) return false;
+
+        // Only the rank just behind a pawn of the side that moved can be a target
+        int ep_rank = parsed.sideToMove == WHITE ? 5 : 2;
+        if (ep_sq / 8 != ep_rank) return false;
+
+        // The target and the pawn's origin must be empty, with the enemy pawn in front of it.
+        // Otherwise no double push happened and the square is dropped, it would generate a bogus capture
+        int push = parsed.sideToMove == WHITE ? -8 : 8;
+        Piece enemy_pawn = parsed.sideToMove == WHITE ? BLACK_PAWN : WHITE_PAWN;
+        if (parsed.board_state.piece_at(ep_sq) == NO_PIECE
+            && parsed.board_state.piece_at(ep_sq - push) == NO_PIECE
+            && parsed.board_state.piece_at(ep_sq + push) == enemy_pawn) {
+            parsed.en_passant_sq = static_cast<int8_t>(ep_sq);
+        }
+    }
+
+    // The side that just moved cannot have left its king in check, the generator would capture it
+    Color opponent = parsed.sideToMove == WHITE ? BLACK : WHITE;
+    int opponent_king_sq = __builtin_ctzll(parsed.board_state.king(opponent));
+    if (parsed.board_state.getAttackersForSq(opponent, opponent_king_sq) != 0) return false;
+
+    parsed.halfmove_clock = static_cast<uint16_t>(halfmove);
+    parsed.fullmove_number = fullmove;
+
+    // BoardState hashed the pieces, add the rest of the state
+    parsed.board_state.xor_key(ZOBRIST.castling[parsed.castling_rights]);
+    parsed.board_state.xor_key(zobrist_en_passant_key(parsed.en_passant_sq));
+    if (parsed.sideToMove == BLACK) parsed.board_state.xor_key(ZOBRIST.side);
+
+    *this = parsed;
+    return true;
+}
+
+
+// Finds the legal move written in coordinate notation ("e2e4", "e7e8q")
+uint16_t Game::find_move(const std::string& move_str) {
+    if (move_str.size() < 4) return 0;
+
+    int from_sq = square_from_string(move_str.substr(0, 2));
+    int to_sq = square_from_string(move_str.substr(2, 2));
+    if (from_sq == NO_SQ || to_sq == NO_SQ) return 0;
+
+    // Promotions without a suffix are to a queen, other moves take no suffix
+    bool has_suffix = move_str.size() > 4;
+    if (move_str.size() > 5) return 0;
+    char promotion = has_suffix ? move_str[4] : 'q';
+
+    MoveList move_list;
+    generate_all_legal(move_list);
+
+    for (uint16_t move_code : move_list) {
+        int move_from = (move_code >> 6) & 0b111111U;
+        int move_to = move_code & 0b111111U;
+        if (move_from != from_sq || move_to != to_sq) continue;
+
+        if (is_promotion(move_code)) {
+            if (promotion_char(move_code) != promotion) continue;
+        } else if (has_suffix) {
+            return 0;
+        }
+        return move_code;
+    }
+    return 0;
+}
@@ -1,54 +1,42 @@
 #include "Game.h"
 
-void Game::user_moves(uint16_t move_code) {
-    make_move(move_code);
-    stream_move_data(move_code);
-    // we don't stream promotion_pc here, it's not necessary
-
-    if (promotion_sq != NO_SQ) {
-        std::cout << "event_data " << static_cast<int>(promotion_sq) << std::endl;
-        std::cout << "event " << eventMessages[PROMOTION] << std::endl; // "promotion"
-        std::cout << "awaiting\n";
-    } else {
-        changeTurn();
-
-        // these detectors can only be called in own turn
-        uint64_t threats = detect_check();
-        detect_game_over();
-
-        std::cout << "event_data " << threats << std::endl;
-        std::cout << "event " << eventMessages[game_event] << std::endl;
-        std::cout << "nextturn\n";
-    }
-    
-}
-
+// The move code carries the promotion piece, so a promotion is a single command
+void Game::user_moves(uint16_t move_code, std::ostream& out) {
+    make_game_move(move_code);
+    stream_move_data(move_code, out);
 
-void Game::user_promotion(int promotion) {
-    Piece promotion_pc = board_state.promote(static_cast<int>(promotion_sq), static_cast<Type>(promotion));
-    
     changeTurn();
 
     // these detectors can only be called in own turn
     uint64_t threats = detect_check();
     detect_game_over();
 
-    // stream adapted to match the move_data format
-    std::cout << "move_data " << -1 << " " << -1 << " " << -1 << " " << static_cast<int>(promotion_sq) << std::endl;
-    std::cout << "promotion_pc " << static_cast<int>(promotion_pc) << std::endl;
-    std::cout << "event_data " << threats << std::endl;
-    std::cout << "event " << eventMessages[game_event] << std::endl;
-    std::cout << "nextturn\n";
+    out << "event_data " << threats << std::endl;
+    out << "event " << eventMessages[game_event] << std::endl;
+    out << "nextturn\n";
+}
+
 
-    promotion_sq = NO_SQ;
+// Plays a game move without streaming anything
+void Game::play_move(uint16_t move_code) {
+    make_game_move(move_code);
+    changeTurn();
+}
+
+
+// The search's undo stack only holds its own line, the keys of game moves go to the
+// game history so repetitions can reach back before the root
+void Game::make_game_move(uint16_t move_code) {
+    make_move(move_code);
+    game_history[game_moves++ % GAME_HISTORY_SIZE] = undo_stack[ply].prev_key;
 }
 
 
 // use this function for both user_moves and engine_moves
-void Game::stream_move_data(uint16_t move_code) {
+void Game::stream_move_data(uint16_t move_code, std::ostream& out) {
     int from_sq = (move_code >> 6) & 0b111111U;
     int to_sq = move_code & 0b111111U;
-    MoveType move_type = static_cast<MoveType>(move_code >> 12);
+    MoveType move_type = move_kind(move_code);
 
     MoveStream stream_data = {NO_SQ, NO_SQ, from_sq, to_sq};
 
@@ -79,21 +67,26 @@ void Game::stream_move_data(uint16_t move_code) {
         }
         
         default: {
-            std::cout << "Error, calling stream_move_data function with an undefined move type: " 
-                      << static_cast<int>(move_type) << std::endl;
+            out << "Error, calling stream_move_data function with an undefined move type: " 
+                << static_cast<int>(move_type) << std::endl;
             return;
         }
     }
 
-    std::cout << "move_data " << stream_data.from_sq_1 << " " << stream_data.to_sq_1 << " ";
-    std::cout << stream_data.from_sq_2 << " " << stream_data.to_sq_2 << " " << std::endl;
+    out << "move_data " << stream_data.from_sq_1 << " " << stream_data.to_sq_1 << " ";
+    out << stream_data.from_sq_2 << " " << stream_data.to_sq_2 << " " << std::endl;
+
+    // make_move already promoted, the piece on to_sq is the new one
+    if (is_promotion(move_code)) {
+        out << "promotion_pc " << static_cast<int>(board_state.piece_at(to_sq)) << std::endl;
+    }
 }
 
 
 // this is the new stream format I figured out for the UCI
 // printed in console as strings would be something like this:
 // ** move_data -1 -1 12 28  // these are squares, -1 is equivalent to NO_SQ
-// ** promotion_pc 12   // 12 is equivalent to NO_PIECE, meaning not promoted
-// ** event: "none" or "check" or "checkmate" or "stalemate" or "promotion"
-// ** event_data: x  // x can be either a bitboard with threats if was event was check, or the promotion square if was event was promotion if user promotion was detected
-// ** 'nextturn' or 'awating' // 'nextturn' means the turn has changed, 'awating' means engine is waiting for user input, in user promotion, for example
\ No newline at end of file
+// ** promotion_pc 10   // only after a promotion, the piece the pawn became
+// ** event: "none" or "check" or "checkmate" or "stalemate"
+// ** event_data: x  // x is a bitboard with threats if event was check
+// ** 'nextturn' // the turn has changed
\ No newline at end of file
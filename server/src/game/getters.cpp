@@ -1,85 +1,234 @@
 #include "Game.h"
+#include <algorithm>
+
+// Legal moves of the piece on from_sq, for the UI. Errors go to out with the moves
+void Game::get_legal_moves(int from_sq, MoveList& move_list, std::ostream& out) {
+    move_list.clear();
 
-std::vector<uint16_t> Game::get_legal_moves(int from_sq) {
     // Input validation
     if (from_sq < 0 || from_sq > 63) {
-        std::cout << "Error, calling get_legal_moves with square number out of range" << std::endl;
-        return {};
+        out << "Error, calling get_legal_moves with square number out of range" << std::endl;
+        return;
     }
 
     Piece piece = board_state.piece_at(from_sq);
     if (piece == NO_PIECE) {
-        std::cout << "Error, calling get_legal_moves with an empty square" << std::endl;
-        return {};
+        out << "Error, calling get_legal_moves with an empty square" << std::endl;
+        return;
     }
 
     if (colorOf(piece) != sideToMove) {
-        std::cout << "Error, attempting to call get_legal_moves function with a piece of the opposite turn" << std::endl;
-        return {};
+        out << "Error, attempting to call get_legal_moves function with a piece of the opposite turn" << std::endl;
+        return;
     }
 
-    // Get pseudo-legal moves
-    uint64_t pseudo_moves = board_state.getPseudoLegalMoves(from_sq);
-    
-    // Early exit if no pseudo-legal moves
-    if (pseudo_moves == 0) { return {}; }
+    // Same generator as the search, so pins and checks are always current
+    MoveList all_moves;
+    generate_all_legal(all_moves);
 
-    // Initialize counters
-    high_priority_count = 0;
-    medium_priority_count = 0;
-    low_priority_count = 0;
+    for (uint16_t move_code : all_moves) {
+        if (((move_code >> 6) & 0x3F) == from_sq) move_list.push(move_code);
+    }
+}
 
-    Type piece_type = board_state.getType(piece);
-    bool is_king = (piece_type == KING);
-    bool is_pawn = (piece_type == PAWN);
+// Generates every legal move of the side to move, check and pin data is computed once
+void Game::generate_all_legal(MoveList& move_list) {
+    generate_legal(move_list, false);
+}
 
-    // Get king position and check status
-    int king_sq = __builtin_ctzll(board_state.king(sideToMove));
-    uint64_t king_attackers = board_state.getAttackersForSq(sideToMove, king_sq);
-    int num_attackers = __builtin_popcountll(king_attackers);
+// Captures, en passant and promotions only, used by the quiescence search
+void Game::generate_captures(MoveList& move_list) {
+    generate_legal(move_list, true);
+}
 
-    // Add en passant moves
-    if (is_pawn && en_passant_sq != NO_SQ) {
-        pseudo_moves |= get_en_passant_bb(from_sq);
-    }
+// The side to move is dispatched once here, below it every color-dependent value is a constant
+void Game::generate_legal(MoveList& move_list, bool captures_only) {
+    if (sideToMove == WHITE) generate_legal<WHITE>(move_list, captures_only);
+    else generate_legal<BLACK>(move_list, captures_only);
+}
 
-    // Calculate allowed destination squares in check
-    uint64_t allowed_moves = calculate_allowed_moves_in_check(king_attackers, num_attackers);
+template <Color Us>
+void Game::generate_legal(MoveList& move_list, bool captures_only) {
+    using Traits = ColorTraits<Us>;
+    move_list.clear();
 
-    int move_count = 0;
-    uint64_t enemy_bb = board_state.color_bb(static_cast<Color>(1 - sideToMove));
+    const PositionInfo& info = position_info();
 
-    // Process each pseudo-legal move
-    while (pseudo_moves) {
-        int to_sq = __builtin_ctzll(pseudo_moves);
-        uint64_t to_sq_bb = 1ULL << to_sq;
-        pseudo_moves &= pseudo_moves - 1; // Remove LSB
+    int king_sq = __builtin_ctzll(board_state.king(Us));
+    int num_attackers = __builtin_popcountll(info.checkers);
 
-        // Skip if move is illegal
-        if (!is_legal_move(from_sq, to_sq, piece, king_sq, num_attackers, allowed_moves, enemy_bb)) {
-            continue;
+    uint64_t enemy_bb = board_state.color_bb(Traits::them);
+
+    // In double check only the king can move. Pawns are generated all at once below
+    uint64_t friendly_bb = num_attackers > 1
+        ? board_state.king(Us)
+        : board_state.color_bb(Us) & ~board_state.piece_bb(static_cast<Piece>(PAWN + Traits::own_offset));
+
+    while (friendly_bb) {
+        int from_sq = __builtin_ctzll(friendly_bb);
+        friendly_bb &= friendly_bb - 1;
+
+        Type piece_type = board_state.getType(board_state.piece_at(from_sq));
+
+        uint64_t pseudo_moves = board_state.pseudo_legal_moves<Us>(from_sq, piece_type);
+        if (captures_only) {
+            pseudo_moves &= enemy_bb;
+        }
+
+        while (pseudo_moves) {
+            int to_sq = __builtin_ctzll(pseudo_moves);
+            uint64_t to_sq_bb = 1ULL << to_sq;
+            pseudo_moves &= pseudo_moves - 1;
+
+            if (!is_legal_move<Us>(from_sq, to_sq, piece_type, king_sq, info)) {
+                continue;
+            }
+
+            MoveType move_type = get_move_type<Us>(to_sq_bb);
+            move_list.push(static_cast<uint16_t>((move_type << 12) | (from_sq << 6) | to_sq));
+        }
+
+        if (piece_type == KING && num_attackers == 0 && !captures_only) {
+            for (uint16_t castling_move : get_castling_move<Us>(from_sq)) {
+                if (castling_move != 0) move_list.push(castling_move);
+            }
         }
+    }
+
+    generate_pawn_moves<Us>(move_list, captures_only, king_sq, info);
+}
+
+// Every pawn at once: each target set is the pawn bitboard shifted by one offset,
+// so the origin of a target is always to_sq - offset
+template <Color Us>
+void Game::generate_pawn_moves(MoveList& move_list, bool captures_only, int king_sq, const PositionInfo& info) {
+    using Traits = ColorTraits<Us>;
+
+    if (info.check_mask == 0) return; // double check
+
+    uint64_t pawns = board_state.piece_bb(static_cast<Piece>(PAWN + Traits::own_offset));
+    uint64_t empty = ~board_state.occupied();
+    uint64_t enemy_bb = board_state.color_bb(Traits::them);
 
-        // Determine move type and add to array
-        MoveType move_type = get_move_type(from_sq, to_sq, piece, enemy_bb, to_sq_bb);
-        uint16_t move_code = static_cast<uint16_t>((move_type << 12) | (from_sq << 6) | to_sq);
-        prioritize_and_store_move(move_code);
+    uint64_t single_push = shift<Traits::push>(pawns) & empty;
+    uint64_t double_push = shift<Traits::push>(single_push & Traits::double_push_row) & empty;
+    uint64_t west_captures = shift<Traits::capture_west>(pawns & ~FILE_A_BB) & enemy_bb;
+    uint64_t east_captures = shift<Traits::capture_east>(pawns & ~FILE_H_BB) & enemy_bb;
+
+    if (captures_only) {
+        single_push &= Traits::promotion_row;
+        double_push = 0;
+    }
+
+    // In single check only captures of the checker and blocks are left
+    single_push &= info.check_mask;
+    double_push &= info.check_mask;
+    west_captures &= info.check_mask;
+    east_captures &= info.check_mask;
+
+    // Only pinned pawns need the full legality test. A promotion is pushed once per piece
+    auto serialise = [&](uint64_t targets, int offset, MoveType move_type) {
+        while (targets) {
+            int to_sq = __builtin_ctzll(targets);
+            targets &= targets - 1;
+            int from_sq = to_sq - offset;
+
+            if (((info.pinned >> from_sq) & 1ULL) && !is_legal_move<Us>(from_sq, to_sq, PAWN, king_sq, info)) {
+                continue;
+            }
+            if (move_type & PROMOTION) {
+                for (int piece = PROMOTION_PIECES.size() - 1; piece >= 0; --piece) {
+                    move_list.push(promotion_move(move_type, piece, from_sq, to_sq));
+                }
+            } else {
+                move_list.push(static_cast<uint16_t>((move_type << 12) | (from_sq << 6) | to_sq));
+            }
+        }
+    };
+
+    serialise(single_push & ~Traits::promotion_row, Traits::push, MOVE);
+    serialise(double_push, 2 * Traits::push, MOVE);
+    serialise(west_captures & ~Traits::promotion_row, Traits::capture_west, CAPTURE);
+    serialise(east_captures & ~Traits::promotion_row, Traits::capture_east, CAPTURE);
+
+    serialise(single_push & Traits::promotion_row, Traits::push, PROMOTION);
+    serialise(west_captures & Traits::promotion_row, Traits::capture_west, PROMOTION_CAPTURE);
+    serialise(east_captures & Traits::promotion_row, Traits::capture_east, PROMOTION_CAPTURE);
+
+    // En passant: our pawns standing where an enemy pawn on the target square would attack.
+    // The check mask does not apply (the captured pawn may be the checker), is_legal_en_passant decides
+    if (en_passant_sq != NO_SQ) {
+        uint64_t attackers = pawns & ColorTraits<Traits::them>::pawn_attacks()[en_passant_sq];
+        while (attackers) {
+            int from_sq = __builtin_ctzll(attackers);
+            attackers &= attackers - 1;
+
+            if (is_legal_en_passant<Us>(from_sq, en_passant_sq, king_sq)) {
+                move_list.push(static_cast<uint16_t>((EN_PASSANT << 12) | (from_sq << 6) | en_passant_sq));
+            }
+        }
     }
+}
+
+// Verifies a move code that did not come from the generator (e.g. a hash move)
+// without generating the move list: the code must describe a move of our piece
+// that the generator would emit, then the usual check and pin tests decide
+bool Game::is_legal(uint16_t move_code) {
+    return sideToMove == WHITE ? is_legal<WHITE>(move_code) : is_legal<BLACK>(move_code);
+}
+
+template <Color Us>
+bool Game::is_legal(uint16_t move_code) {
+    using Traits = ColorTraits<Us>;
+
+    int from_sq = (move_code >> 6) & 0x3F;
+    int to_sq = move_code & 0x3F;
+    uint8_t raw_type = move_code >> 12;
+    MoveType type = move_kind(move_code);
+
+    // Values 4-7 of the type field are unused
+    if (!(raw_type & PROMOTION) && raw_type > EN_PASSANT) return false;
+
+    Piece piece = board_state.piece_at(from_sq);
+    if (piece == NO_PIECE || colorOf(piece) != Us) return false;
+    Type piece_type = board_state.getType(piece);
+
+    const PositionInfo& info = position_info();
+    int king_sq = __builtin_ctzll(board_state.king(Us));
 
-    // Handle castling for kings
-    if (is_king && num_attackers == 0) {
-        add_castling_moves(from_sq);
+    if (type == CASTLING) {
+        if (piece_type != KING || info.checkers) return false;
+        std::array<uint16_t, 2> castling_moves = get_castling_move<Us>(from_sq);
+        return move_code == castling_moves[0] || move_code == castling_moves[1];
     }
 
-    // Combine moves by priority
-    std::vector<uint16_t> ordered_moves;
-    ordered_moves.reserve(high_priority_count + medium_priority_count + low_priority_count);
+    if (type == EN_PASSANT) {
+        return piece_type == PAWN && to_sq == en_passant_sq
+            && ((ColorTraits<Traits::them>::pawn_attacks()[to_sq] >> from_sq) & 1ULL)
+            && is_legal_en_passant<Us>(from_sq, to_sq, king_sq);
+    }
 
-    ordered_moves.insert(ordered_moves.end(), high_priority_moves.begin(), high_priority_moves.begin() + high_priority_count);
-    ordered_moves.insert(ordered_moves.end(), medium_priority_moves.begin(), medium_priority_moves.begin() + medium_priority_count);
-    ordered_moves.insert(ordered_moves.end(), low_priority_moves.begin(), low_priority_moves.begin() + low_priority_count);
+    uint64_t to_sq_bb = 1ULL << to_sq;
+    bool is_capture = type == CAPTURE || type == PROMOTION_CAPTURE;
+    if (is_capture != ((board_state.color_bb(Traits::them) & to_sq_bb) != 0)) return false;
+
+    if (piece_type == PAWN) {
+        // Promotions are exactly the pawn moves that reach the last rank
+        if (is_promotion(move_code) != ((Traits::promotion_row & to_sq_bb) != 0)) return false;
+
+        uint64_t empty = ~board_state.occupied();
+        uint64_t from_sq_bb = 1ULL << from_sq;
+        uint64_t single_push = shift<Traits::push>(from_sq_bb) & empty;
+        uint64_t targets = is_capture
+            ? Traits::pawn_attacks()[from_sq]
+            : single_push | (shift<Traits::push>(single_push & Traits::double_push_row) & empty);
+        if (!(targets & to_sq_bb)) return false;
+    } else {
+        if (is_promotion(move_code)) return false;
+        if (!(board_state.pseudo_legal_moves<Us>(from_sq, piece_type) & to_sq_bb)) return false;
+    }
 
-    return ordered_moves;
+    return is_legal_move<Us>(from_sq, to_sq, piece_type, king_sq, info);
 }
 
 // Calculate allowed moves when in check
@@ -103,17 +252,14 @@ uint64_t Game::calculate_allowed_moves_in_check(uint64_t king_attackers, int num
 }
 
 // Check if a move is legal
-bool Game::is_legal_move(int from_sq, int to_sq, Piece piece, int king_sq, 
-                        int num_attackers, uint64_t allowed_moves, uint64_t enemy_bb) {
-    Type piece_type = board_state.getType(piece);
-    bool is_king = (piece_type == KING);
+template <Color Us>
+bool Game::is_legal_move(int from_sq, int to_sq, Type piece_type, int king_sq, const PositionInfo& info) {
     uint64_t to_sq_bb = 1ULL << to_sq;
 
     // King moves: check if destination is attacked
-    if (is_king) {
-        if (num_attackers >= 1) { // in check
-            uint64_t linear_attackers = board_state.getAttackersForSq(sideToMove, king_sq) 
-            & board_state.getLinearThreats(sideToMove);
+    if (piece_type == KING) {
+        if (info.checkers) { // in check
+            uint64_t linear_attackers = info.checkers & board_state.linear_threats<Us>();
 
             while (linear_attackers) {
                 int attacker_sq = __builtin_ctzll(linear_attackers);
@@ -124,141 +270,52 @@ bool Game::is_legal_move(int from_sq, int to_sq, Piece piece, int king_sq,
             }
         }
 
-        return board_state.getAttackersForSq(sideToMove, to_sq) == 0;
+        return board_state.attackers_to<Us>(to_sq) == 0;
     }
 
     // Non-king in double check cannot move
-    if (num_attackers > 1) {
+    if (info.check_mask == 0) {
         return false;
     }
 
-    // Check if move is on allowed squares in single check
-    if (num_attackers == 1) {
-        // En passant special case
-        if (to_sq == en_passant_sq && piece_type == PAWN) {
-            int captured_pawn_sq = sideToMove ? (to_sq - 8) : (to_sq + 8);
-            uint64_t king_attackers = board_state.getAttackersForSq(sideToMove, king_sq);
-            int attacker_sq = __builtin_ctzll(king_attackers);
-            return (captured_pawn_sq == attacker_sq);
-        }
-        
-        return (allowed_moves & to_sq_bb) != 0;
+    // En passant removes two pawns from the same rank, simulate it to catch every pin
+    if (to_sq == en_passant_sq && piece_type == PAWN) {
+        return is_legal_en_passant<Us>(from_sq, to_sq, king_sq);
     }
 
-    // Check pinned pieces
-    if (pinned_rays[from_sq] != 0) {
-        return (pinned_rays[from_sq] & to_sq_bb) != 0;
+    // Check if move is on allowed squares in single check
+    if ((info.check_mask & to_sq_bb) == 0) {
+        return false;
     }
 
-    return true;
-}
-
-// Determine move type
-MoveType Game::get_move_type(int from_sq, int to_sq, Piece piece, uint64_t enemy_bb, uint64_t to_sq_bb) {
-    Type piece_type = board_state.getType(piece);
-    bool is_capture = (enemy_bb & to_sq_bb) != 0;
-    
-    // En passant
-    if (piece_type == PAWN && to_sq == en_passant_sq) {
-        return EN_PASSANT;
+    // Check pinned pieces (a pinned piece can't capture or block a check off its ray):
+    // it either slides towards the king or away from it, pinner included
+    if ((info.pinned >> from_sq) & 1ULL) {
+        return ((ray_between_table[king_sq][from_sq] & to_sq_bb) != 0)
+            || ((ray_between_table[king_sq][to_sq] >> from_sq) & 1ULL);
     }
-    
-    // Promotion
-    if (piece_type == PAWN && ((PROMOTION_ROWS[sideToMove] >> to_sq) & 1ULL)) {
-        return is_capture ? PROMOTION_CAPTURE : PROMOTION;
-    }
-    
-    // Regular move or capture
-    return is_capture ? CAPTURE : MOVE;
-}
 
-// Add castling moves
-void Game::add_castling_moves(int from_sq) {
-    std::array<uint16_t, 2> castling_moves = get_castling_move(from_sq);
-    for (int i = 0; i < 2; ++i) {
-        if (castling_moves[i] != 0) {
-            medium_priority_moves[medium_priority_count] = castling_moves[i];
-            medium_priority_count++;
-        }
-    }
+    return true;
 }
 
-bool Game::would_be_check(uint16_t move_code) {
-    // Data
-    Color enemy_side = static_cast<Color>(1 - sideToMove);
-    int enemy_king_sq = __builtin_ctzll(board_state.king(enemy_side));
-
-    // Decompress move
-    int from = (move_code >> 6) & 0b111111U;
-    int to = move_code & 0b111111U;
-    MoveType type = static_cast<MoveType>(move_code >> 12);
-
-    if (board_state.getType(board_state.piece_at(to)) == KING) {
-        std::cout << "Simulation with KING not allowed" << std::endl;
-        return false;
-    }
-
-    bool is_check = false;
-    bool is_capture = type == CAPTURE || type == PROMOTION_CAPTURE;
-    Piece enemy = NO_PIECE;
-
-    // Simulate move
-    if (is_capture) enemy = board_state.deletePiece(to);
+// Simulates the capture and verifies that the king is not left in check
+template <Color Us>
+bool Game::is_legal_en_passant(int from_sq, int to_sq, int king_sq) {
+    int captured_pawn_sq = to_sq - ColorTraits<Us>::push;
 
-    board_state.movePiece(from, to);
+    Piece captured = board_state.deletePiece(captured_pawn_sq);
+    board_state.movePiece(from_sq, to_sq);
 
-    // Verify check
-    is_check = board_state.getAttackersForSq(enemy_side, enemy_king_sq) > 0;
+    bool is_legal = board_state.attackers_to<Us>(king_sq) == 0;
 
-    // Reverse move
-    board_state.movePiece(to, from);
-    if (is_capture) board_state.addPiece(to, enemy);
+    board_state.movePiece(to_sq, from_sq);
+    board_state.addPiece(captured_pawn_sq, captured);
 
-    return is_check;
+    return is_legal;
 }
 
-void Game::prioritize_and_store_move(uint16_t move_code) {
-    // High priority: checks
-    if (would_be_check(move_code)) {
-        high_priority_moves[high_priority_count++] = move_code;
-        return;
-    }
-
-    MoveType type = static_cast<MoveType>(move_code >> 12);
-
-    // Medium priority: promotions
-    if (type == PROMOTION || type == PROMOTION_CAPTURE) {
-        medium_priority_moves[medium_priority_count++] = move_code;
-        return;
-    }
-
-    // Evaluate captures
-    if (type == CAPTURE) {
-        int from_sq = (move_code >> 6) & 0x3F;
-        Piece attacker_piece = board_state.piece_at(from_sq);
-        Type attacker_type = board_state.getType(attacker_piece);
-
-        int to_sq = move_code & 0x3F;
-        Piece victim_piece = board_state.piece_at(to_sq);
-        Type victim_type = board_state.getType(victim_piece);
-
-        // Good capture: high priority
-        if (PIECE_BASE_VALUE[victim_type] >= PIECE_BASE_VALUE[attacker_type]) {
-            high_priority_moves[high_priority_count++] = move_code;
-        }
-        // Bad capture: low priority
-        else {
-            low_priority_moves[low_priority_count++] = move_code;
-        }
-        return;
-    }
-    
-    // Low priority: en passant
-    if (type == EN_PASSANT) {
-        low_priority_moves[low_priority_count++] = move_code;
-        return;
-    }
-
-    // Low priority: quiet moves
-    low_priority_moves[low_priority_count++] = move_code;
-}
\ No newline at end of file
+// Move type of a piece move, pawns (en passant and promotions) come from generate_pawn_moves
+template <Color Us>
+MoveType Game::get_move_type(uint64_t to_sq_bb) {
+    return (board_state.color_bb(ColorTraits<Us>::them) & to_sq_bb) ? CAPTURE : MOVE;
+}
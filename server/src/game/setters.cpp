@@ -6,12 +6,18 @@
 void Game::make_move(uint16_t move_code) {
     int from_sq = (move_code >> 6) & 0b111111U;
     int to_sq = move_code & 0b111111U;
-    MoveType move_type = static_cast<MoveType>(move_code >> 12);
+    MoveType move_type = move_kind(move_code);
     
     Piece moving_piece = board_state.piece_at(from_sq);
     Piece captured_piece = NO_PIECE;
     int8_t new_ep_sq = NO_SQ;
 
+    assert(ply >= 0 && ply < MAX_PLY && "undo stack overflow");
+#ifdef COPY_MAKE
+    board_stack[ply] = board_state;
+#endif
+    uint64_t prev_key = board_state.key();
+
     switch (move_type) {
         case MOVE: {
             // Check for double pawn push (creates en passant opportunity)
@@ -41,23 +47,23 @@ void Game::make_move(uint16_t move_code) {
             break;
         }
         
+        // The pawn leaves and the piece in the move code appears on to_sq
         case PROMOTION: {
-            board_state.movePiece(from_sq, to_sq);
-            promotion_sq = to_sq;
+            board_state.deletePiece(from_sq);
+            board_state.addPiece(to_sq, static_cast<Piece>(promotion_piece(move_code) + sideToMove * PC_NUM));
             break;
         }
         
         case PROMOTION_CAPTURE: {
-            captured_piece = board_state.piece_at(to_sq);
-            board_state.deletePiece(to_sq);
-            board_state.movePiece(from_sq, to_sq);
-            promotion_sq = to_sq;
+            captured_piece = board_state.deletePiece(to_sq);
+            board_state.deletePiece(from_sq);
+            board_state.addPiece(to_sq, static_cast<Piece>(promotion_piece(move_code) + sideToMove * PC_NUM));
             break;
         }
         
+        // Unreachable: game moves come from the generator or are checked with is_legal first
         default: {
-            std::cout << "Error, calling make_move function with an undefined move type: " 
-                      << static_cast<int>(move_type) << std::endl;
+            assert(false && "make_move: undefined move type");
             return;
         }
     }
@@ -67,22 +73,39 @@ void Game::make_move(uint16_t move_code) {
         move_code, 
         captured_piece,
         en_passant_sq, 
-        castling_rights
+        castling_rights,
+        halfmove_clock,
+        prev_key
     };
 
+    // Captures and pawn moves reset the fifty-move counter
+    bool is_pawn_move = board_state.getType(moving_piece) == PAWN;
+    halfmove_clock = (captured_piece != NO_PIECE || is_pawn_move) ? 0 : halfmove_clock + 1;
+    if (sideToMove == BLACK) fullmove_number++;
+
     undo_stack[ply] = undo_info;
+
+    // Pieces are hashed by BoardState, here we swap the state components
+    board_state.xor_key(zobrist_en_passant_key(en_passant_sq) ^ zobrist_en_passant_key(new_ep_sq));
+    board_state.xor_key(ZOBRIST.castling[castling_rights]);
+
     en_passant_sq = new_ep_sq;
-    update_castling_rights(to_sq);
-    set_pinned_pieces();
+    update_castling_rights(from_sq, to_sq);
+    board_state.xor_key(ZOBRIST.castling[castling_rights]);
 }
 
 
 void Game::unmake_move() {
     UndoInfo undo_info = undo_stack[ply];
+
+#ifdef COPY_MAKE
+    // Pieces, hash key and PSQ score come back with the saved board
+    board_state = board_stack[ply];
+#else
     uint16_t move_code = undo_info.move_code;
     int from_sq = (move_code >> 6) & 0b111111U;
     int to_sq = move_code & 0b111111U;
-    MoveType move_type = static_cast<MoveType>(move_code >> 12);
+    MoveType move_type = move_kind(move_code);
     
     // Restore move based on type (reverse of make_move)
     switch (move_type) {
@@ -125,43 +148,44 @@ void Game::unmake_move() {
         }
         
         default: {
-            std::cout << "Error, attempting to call unmake_move function with undefined move type: " 
-                      << static_cast<int>(move_type) << std::endl;
+            assert(false && "unmake_move: undefined move type");
             return;
         }
     }
 
     // Restore game state
+    board_state.xor_key(zobrist_en_passant_key(en_passant_sq) ^ zobrist_en_passant_key(undo_info.prev_en_passant_sq));
+    board_state.xor_key(ZOBRIST.castling[castling_rights] ^ ZOBRIST.castling[undo_info.prev_castling_rights]);
+#endif
+
     castling_rights = undo_info.prev_castling_rights;
+    halfmove_clock = undo_info.prev_halfmove_clock;
+    if (sideToMove == BLACK) fullmove_number--;
     en_passant_sq = undo_info.prev_en_passant_sq;
-    promotion_sq = NO_SQ;
-    set_pinned_pieces();
 }
 
 
-void Game::update_castling_rights(int to_sq) {
-    Piece pc = board_state.piece_at(to_sq);
-    Type type = board_state.getType(pc);
-    // early exit if piece is neither rook nor king
-    if (type != ROOK && type != KING) return;
+// Null move: nothing moves, only the en passant square is lost
+void Game::make_null_move() {
+    assert(ply >= 0 && ply < MAX_PLY && "undo stack overflow");
+    undo_stack[ply] = {0, NO_PIECE, en_passant_sq, castling_rights, halfmove_clock, board_state.key()};
 
-    if (castling_rights == 0) return;
+    board_state.xor_key(zobrist_en_passant_key(en_passant_sq) ^ zobrist_en_passant_key(NO_SQ));
+    en_passant_sq = NO_SQ;
+    halfmove_clock = 0; // no repetition goes across a null move
+}
 
-    switch (type)
-    {
-    case KING:{
-        uint8_t remaining_rights = sideToMove ? 0b1100U : 0b0011U;
-        castling_rights &= remaining_rights;
-        }
-        break;
-    
-    case ROOK:{
-        int rook_idx = getCastlingIdx(to_sq);
-        castling_rights &= ~(1U << rook_idx);
-        }
-        break;
 
-    default:
-        break;
-    }
+void Game::unmake_null_move() {
+    const UndoInfo& undo_info = undo_stack[ply];
+
+    board_state.xor_key(zobrist_en_passant_key(NO_SQ) ^ zobrist_en_passant_key(undo_info.prev_en_passant_sq));
+    en_passant_sq = undo_info.prev_en_passant_sq;
+    halfmove_clock = undo_info.prev_halfmove_clock;
+}
+
+
+// Moving from or capturing on a king/rook home square drops the matching rights
+void Game::update_castling_rights(int from_sq, int to_sq) {
+    castling_rights &= CASTLING_RIGHTS_MASK[from_sq] & CASTLING_RIGHTS_MASK[to_sq];
 }
\ No newline at end of file
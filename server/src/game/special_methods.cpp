@@ -1,48 +1,20 @@
 #include "Game.h"
-#include <cstdlib>
 #include <array>
 
-uint64_t Game::get_en_passant_bb(int from_sq) const {
-    uint64_t current_track = sideToMove ? WHITE_EN_PASSANT_TRACK : BLACK_EN_PASSANT_TRACK;
-    
-    if (!((current_track >> from_sq) & 1ULL)) {
-        return 0;
-    }
-
-    bool isPinned = (pinned_rays[from_sq] != 0);
-    uint64_t pin_ray = pinned_rays[from_sq];
-
-    // en_passant_square es un int8_t, por lo que -1 o algún otro valor puede indicar que no hay captura al paso
-    if (
-        en_passant_sq != NO_SQ &&
-        std::abs(en_passant_sq % 8 - from_sq % 8) == 1
-    ) {
-        if (isPinned) {
-            return (pin_ray & en_passant_sq) ? (1ULL << en_passant_sq) : 0;
-        }
-        return (1ULL << en_passant_sq);
-    }
-    
-    return 0;
-}
-
-
+template <Color Us>
 std::array<uint16_t, 2> Game::get_castling_move(int king_sq) const {
-    uint8_t right_of_king_to_castle = sideToMove ? 0b0011U : 0b1100U;
+    using Traits = ColorTraits<Us>;
 
-    if (!(castling_rights & right_of_king_to_castle)) {
+    if (!(castling_rights & Traits::castling_rights)) {
         return {0U,0U};
     }
 
     uint64_t occupied_bb = board_state.occupied();
     std::array<uint16_t, 2> castling_moves = {0U,0U};
 
-    int q_rook_sq = sideToMove ? 0 : 56;
-    int k_rook_sq = sideToMove ? 7 : 63;
-
-    std::array<int, 2> rook_squares = {q_rook_sq, k_rook_sq};
+    constexpr std::array<int, 2> rook_squares = {Traits::queen_rook_sq, Traits::king_rook_sq};
 
-    Piece rook_idx = static_cast<Piece>(ROOK + (sideToMove * PC_NUM));
+    constexpr Piece rook_idx = static_cast<Piece>(ROOK + Traits::own_offset);
 
     // # This one is to set the final position of the king
     int direction = 2;
@@ -60,16 +32,17 @@ std::array<uint16_t, 2> Game::get_castling_move(int king_sq) const {
         }
         
         std::array<int, 2> castling_squares = getCastlingPath(rook_sq);
-        uint64_t castling_mask = (1ULL << castling_squares[0]) | (1ULL << castling_squares[1]);
+        // Every square between king and rook must be empty (b1/b8 included on queen side)
+        uint64_t castling_mask = ray_between_table[king_sq][rook_sq];
 
         bool is_path_clear = (castling_mask & occupied_bb) == 0;
 
-        bool is_king_safe = board_state.getAttackersForSq(sideToMove, king_sq) == 0;
+        bool is_king_safe = board_state.attackers_to<Us>(king_sq) == 0;
 
         bool is_path_safe = true;
 
         for (int path_sq : castling_squares) {
-            if (board_state.getAttackersForSq(sideToMove, path_sq) != 0ULL) {
+            if (board_state.attackers_to<Us>(path_sq) != 0ULL) {
                 is_path_safe = false;
                 break;
             }
@@ -85,24 +58,38 @@ std::array<uint16_t, 2> Game::get_castling_move(int king_sq) const {
     return castling_moves;
 }
 
+// Solo generate_legal<Us> (getters.cpp) la usa
+template std::array<uint16_t, 2> Game::get_castling_move<WHITE>(int) const;
+template std::array<uint16_t, 2> Game::get_castling_move<BLACK>(int) const;
+
+
+// Checkers and pins of the node at the current ply. The record is keyed by the
+// position hash, so it is computed once per node and is still valid after the
+// children have been made and unmade.
+const PositionInfo& Game::position_info() {
+    PositionInfo& info = info_stack[ply];
+    if (info.key == board_state.key()) return info;
+
+    int king_sq = __builtin_ctzll(board_state.king(sideToMove));
+    uint64_t own_bb = board_state.color_bb(sideToMove);
 
-void Game::set_pinned_pieces() {
-    pinned_rays.fill(0ULL);
+    info.key = board_state.key();
+    info.checkers = board_state.getAttackersForSq(sideToMove, king_sq);
+    info.check_mask = calculate_allowed_moves_in_check(info.checkers, __builtin_popcountll(info.checkers));
+    info.pinned = 0ULL;
 
     uint64_t threats = board_state.getLinearThreats(sideToMove);
 
     while (threats) {
         int threatSq = __builtin_ctzll(threats);
         threats &= threats - 1;
-        
-        uint64_t ray = board_state.getRayBetween(sideToMove, threatSq);
 
-        uint64_t intersection = ray & board_state.color_bb(sideToMove);
+        uint64_t intersection = ray_between_table[threatSq][king_sq] & own_bb;
 
         if (__builtin_popcountll(intersection) == 1) {
-            int pinned_sq = __builtin_ctzll(intersection);
-
-            pinned_rays[pinned_sq] = ray | (1ULL << threatSq);
+            info.pinned |= intersection;
         }
     }
-}
\ No newline at end of file
+
+    return info;
+}
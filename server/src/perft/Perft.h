@@ -0,0 +1,9 @@
+#pragma once
+#include "../game/Game.h"
+#include <iostream>
+
+// Counts leaf nodes of the legal move tree, used to validate and time move generation
+uint64_t perft(Game& game, int depth);
+
+// Same as perft but prints the node count below each root move
+uint64_t perft_divide(Game& game, int depth, std::ostream& out);
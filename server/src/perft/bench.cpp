@@ -0,0 +1,68 @@
+#include "Perft.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <string>
+
+// Standard perft positions, expected counts from the Chess Programming Wiki
+struct PerftPosition {
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t expected;
+};
+
+static const PerftPosition PERFT_SUITE[] = {
+    {"startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609ULL},
+    {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603ULL},
+    {"position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624ULL},
+    {"position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333ULL},
+    {"position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487ULL},
+    {"position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594ULL},
+    // e6 is on the right rank but no black pawn pushed there, the square must be dropped on load
+    {"stale_ep", "4k3/8/8/3P4/8/8/8/4K3 w - e6 0 1", 5, 9906ULL},
+};
+
+int main() {
+    uint64_t total_nodes = 0;
+    double total_seconds = 0.0;
+    int failures = 0;
+
+#ifdef COPY_MAKE
+    std::cout << "unmake: copy-make\n";
+#else
+    std::cout << "unmake: incremental\n";
+#endif
+    std::cout << std::left << std::setw(12) << "position" << std::setw(7) << "depth"
+              << std::setw(12) << "nodes" << std::setw(10) << "ms" << std::setw(12) << "nps" << "result\n";
+
+    for (const PerftPosition& pos : PERFT_SUITE) {
+        Game game;
+        if (!game.set_fen(pos.fen)) {
+            std::cout << pos.name << ": invalid FEN\n";
+            failures++;
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = perft(game, pos.depth);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        bool ok = nodes == pos.expected;
+        if (!ok) failures++;
+
+        total_nodes += nodes;
+        total_seconds += seconds;
+
+        std::cout << std::left << std::setw(12) << pos.name << std::setw(7) << pos.depth
+                  << std::setw(12) << nodes << std::setw(10) << static_cast<uint64_t>(seconds * 1000)
+                  << std::setw(12) << static_cast<uint64_t>(nodes / (seconds > 0 ? seconds : 1e-9))
+                  << (ok ? "ok" : "FAIL (expected " + std::to_string(pos.expected) + ")") << "\n";
+    }
+
+    std::cout << "total " << total_nodes << " nodes in " << static_cast<uint64_t>(total_seconds * 1000)
+              << " ms, " << static_cast<uint64_t>(total_nodes / (total_seconds > 0 ? total_seconds : 1e-9))
+              << " nps\n";
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,53 @@
+#include "Perft.h"
+
+uint64_t perft(Game& game, int depth) {
+    if (depth == 0) return 1;
+
+    MoveList moves;
+    game.generate_all_legal(moves);
+
+    // Bulk counting: the last ply doesn't need make/unmake
+    if (depth == 1) return moves.size();
+
+    uint64_t nodes = 0;
+
+    for (uint16_t move : moves) {
+        game.make_move(move);
+        game.changeTurn();
+        game.increase_ply();
+
+        nodes += perft(game, depth - 1);
+
+        game.decrease_ply();
+        game.changeTurn();
+        game.unmake_move();
+    }
+
+    return nodes;
+}
+
+uint64_t perft_divide(Game& game, int depth, std::ostream& out) {
+    if (depth < 1) return 1;
+
+    MoveList moves;
+    game.generate_all_legal(moves);
+
+    uint64_t total = 0;
+
+    for (uint16_t move : moves) {
+        game.make_move(move);
+        game.changeTurn();
+        game.increase_ply();
+
+        uint64_t nodes = perft(game, depth - 1);
+
+        game.decrease_ply();
+        game.changeTurn();
+        game.unmake_move();
+
+        out << move_to_string(move) << " " << move << ": " << nodes << "\n";
+        total += nodes;
+    }
+
+    return total;
+}
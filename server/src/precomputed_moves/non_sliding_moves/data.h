@@ -6,22 +6,18 @@
 #include <array>   // Para std::array
 
 // --- Tablas de Movimientos y Ataques Precomputados para Rey, Caballo y Peón ---
+// Se generan en tiempo de compilación, quedan en memoria de solo lectura.
 
 // Rey y Caballo: Movimientos
-extern std::array<uint64_t, 64> king_lookup;
-extern std::array<uint64_t, 64> knight_lookup;
+extern const std::array<uint64_t, 64> king_lookup;
+extern const std::array<uint64_t, 64> knight_lookup;
 
 // Peones: Movimientos de Avance
-extern std::array<uint64_t, 64> white_pawn_moves_lookup;
-extern std::array<uint64_t, 64> black_pawn_moves_lookup;
+extern const std::array<uint64_t, 64> white_pawn_moves_lookup;
+extern const std::array<uint64_t, 64> black_pawn_moves_lookup;
 
 // Peones: Ataques (Capturas)
-extern std::array<uint64_t, 64> white_pawn_attacks_lookup;
-extern std::array<uint64_t, 64> black_pawn_attacks_lookup;
+extern const std::array<uint64_t, 64> white_pawn_attacks_lookup;
+extern const std::array<uint64_t, 64> black_pawn_attacks_lookup;
 
-
-// --- Funciones de Inicialización ---
-void init_king_knight_lookups();
-void init_pawn_lookups();
-
-#endif // PIECE_LOOKUP_TABLES_H
\ No newline at end of file
+#endif // PIECE_LOOKUP_TABLES_H
@@ -1,21 +1,22 @@
 // king_knight.cpp
-#include <vector>
 #include <utility>   // Para std::pair
 #include "data.h"
 
+using Offsets = std::array<std::pair<int, int>, 8>;
+
 // Los desplazamientos (offsets) del rey y del caballo se representan como pares (delta rank, delta file)
-const std::vector<std::pair<int, int>> king_offsets = {
+constexpr Offsets king_offsets = {{
     {1, 0}, {1, 1}, {0, 1}, {-1, 1},
     {-1, 0}, {-1, -1}, {0, -1}, {1, -1}
-};
+}};
 
-const std::vector<std::pair<int, int>> knight_offsets = {
+constexpr Offsets knight_offsets = {{
     {2, 1}, {2, -1}, {-2, 1}, {-2, -1},
     {1, 2}, {1, -2}, {-1, 2}, {-1, -2}
-};
+}};
 
-// El tamaño del array (64) debe ser conocido en tiempo de compilación.
-std::array<uint64_t, 64> generate_moves_lookup(const std::vector<std::pair<int, int>>& offsets) {
+// Se evalúa en tiempo de compilación
+constexpr std::array<uint64_t, 64> generate_moves_lookup(const Offsets& offsets) {
     std::array<uint64_t, 64> piece_moves_lookup{}; // Inicialización a ceros, importante
                                                   // {}: inicializa todos los elementos a cero
 
@@ -43,11 +44,5 @@ std::array<uint64_t, 64> generate_moves_lookup(const std::vector<std::pair<int,
     return piece_moves_lookup;
 }
 
-std::array<uint64_t, 64> king_lookup;
-std::array<uint64_t, 64> knight_lookup;
-
-// Función específica para inicializar estas tablas
-void init_king_knight_lookups() {
-    knight_lookup = generate_moves_lookup(knight_offsets);
-    king_lookup = generate_moves_lookup(king_offsets);
-}
\ No newline at end of file
+constexpr std::array<uint64_t, 64> king_lookup = generate_moves_lookup(king_offsets);
+constexpr std::array<uint64_t, 64> knight_lookup = generate_moves_lookup(knight_offsets);
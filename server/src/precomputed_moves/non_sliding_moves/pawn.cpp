@@ -2,7 +2,7 @@
 #include "data.h"
 
 // Función que genera y retorna un std::array de movimientos de peón (avance)
-std::array<uint64_t, 64> generate_pawn_moves_lookup(bool is_white) {
+constexpr std::array<uint64_t, 64> generate_pawn_moves_lookup(bool is_white) {
     std::array<uint64_t, 64> lookup_table{}; // Inicializa todos los elementos a 0
     
     for (int square = 0; square < 64; ++square) {
@@ -36,7 +36,7 @@ std::array<uint64_t, 64> generate_pawn_moves_lookup(bool is_white) {
 
 
 // Función que genera y retorna un std::array de ataques de peón (diagonales)
-std::array<uint64_t, 64> generate_pawn_attacks_lookup(bool is_white) {
+constexpr std::array<uint64_t, 64> generate_pawn_attacks_lookup(bool is_white) {
     std::array<uint64_t, 64> lookup_table{}; // Inicializa todos los elementos a 0
 
     for (int square = 0; square < 64; ++square) {
@@ -71,18 +71,9 @@ std::array<uint64_t, 64> generate_pawn_attacks_lookup(bool is_white) {
 }
 
 // Peones: Movimientos de Avance
-std::array<uint64_t, 64> white_pawn_moves_lookup;
-std::array<uint64_t, 64> black_pawn_moves_lookup;
+constexpr std::array<uint64_t, 64> white_pawn_moves_lookup = generate_pawn_moves_lookup(true);
+constexpr std::array<uint64_t, 64> black_pawn_moves_lookup = generate_pawn_moves_lookup(false);
 
 // Peones: Ataques (Capturas)
-std::array<uint64_t, 64> white_pawn_attacks_lookup;
-std::array<uint64_t, 64> black_pawn_attacks_lookup;
-
-
-// Función específica para inicializar estas tablas
-void init_pawn_lookups() {
-    white_pawn_moves_lookup = generate_pawn_moves_lookup(true);
-    black_pawn_moves_lookup = generate_pawn_moves_lookup(false);
-    white_pawn_attacks_lookup = generate_pawn_attacks_lookup(true);
-    black_pawn_attacks_lookup = generate_pawn_attacks_lookup(false);
-}
+constexpr std::array<uint64_t, 64> white_pawn_attacks_lookup = generate_pawn_attacks_lookup(true);
+constexpr std::array<uint64_t, 64> black_pawn_attacks_lookup = generate_pawn_attacks_lookup(false);
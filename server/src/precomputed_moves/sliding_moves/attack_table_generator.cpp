@@ -0,0 +1,46 @@
+// attack_table_generator.cpp
+// Genera rook_attacks.inc y bishop_attacks.inc a partir de los números mágicos:
+//   ./attack_table_generator rook > rook_attacks.inc
+
+#include "utils.h"
+#include "data.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+void print_attack_table(const std::array<uint64_t, 64>& magics, uint64_t (*generate_mask)(int),
+                        const std::vector<std::pair<int, int>>& directions, const char* name) {
+    std::vector<uint64_t> attack_table;
+
+    for (int square = 0; square < 64; ++square) {
+        uint64_t mask = generate_mask(square);
+        int num_relevant_bits = __builtin_popcountll(mask);
+        size_t offset = attack_table.size();
+
+        std::vector<uint64_t> blocker_combinations = generate_blocker_combinations(mask);
+        attack_table.resize(offset + blocker_combinations.size());
+
+        for (uint64_t relevant_blockers : blocker_combinations) {
+            uint64_t index = (relevant_blockers * magics[square]) >> (64 - num_relevant_bits);
+            attack_table[offset + index] = generate_raw_sliding_attacks(square, relevant_blockers, directions);
+        }
+    }
+
+    std::printf("// Generated by attack_table_generator.cpp (%s), do not edit\n", name);
+    for (size_t i = 0; i < attack_table.size(); ++i) {
+        std::printf("%s0x%016llxULL,%s", i % 4 == 0 ? "    " : " ",
+                    static_cast<unsigned long long>(attack_table[i]), i % 4 == 3 ? "\n" : "");
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc == 2 && std::strcmp(argv[1], "rook") == 0) {
+        print_attack_table(ROOK_MAGICS, generate_rook_mask, rook_directions, "rook");
+    } else if (argc == 2 && std::strcmp(argv[1], "bishop") == 0) {
+        print_attack_table(BISHOP_MAGICS, generate_bishop_mask, bishop_directions, "bishop");
+    } else {
+        std::fprintf(stderr, "usage: %s rook|bishop\n", argv[0]);
+        return 1;
+    }
+    return 0;
+}
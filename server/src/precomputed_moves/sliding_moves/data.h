@@ -5,7 +5,14 @@
 
 #include <cstdint> // Para uint64_t
 #include <array>   // Para std::array
-#include <vector>  // Para std::vector
+#include <cstddef> // Para size_t
+
+#ifdef USE_PEXT
+#ifndef __BMI2__
+#error "USE_PEXT needs a BMI2 target (-mbmi2 or -march=native)"
+#endif
+#include <immintrin.h>
+#endif
 
 
 // Estos números serán usados para indexar las tablas de ataque.
@@ -47,22 +54,44 @@ constexpr std::array<uint64_t, 64> BISHOP_MAGICS = {
     17265703666216497635ULL, 13528250181494197569ULL, 3461194999075843072ULL,  12429843139948337776ULL
 };
 
-extern std::array<uint64_t, 64> rook_masks;
-extern std::array<uint64_t, 64> bishop_masks;
+// Tamaño de las tablas de ataque: suma de 2^bits relevantes de cada casilla
+constexpr size_t ROOK_ATTACK_TABLE_SIZE = 102400;
+constexpr size_t BISHOP_ATTACK_TABLE_SIZE = 71168;
 
+// Todo lo que necesita una consulta de una casilla, junto en una línea de caché.
+// Con USE_PEXT (make PEXT=1, requiere BMI2) el índice sale de pext(occ, mask) y
+// magic/shift no se usan; sin él se usa la multiplicación mágica.
+struct alignas(32) MagicEntry {
+    uint64_t mask;
+    uint64_t magic;
+    const uint64_t* attacks; // primera entrada de esta casilla en la tabla de ataques
+    uint32_t shift;
 
-extern std::array<int, 64> rook_magic_shifts;
-extern std::array<int, 64> bishop_magic_shifts;
+    inline uint64_t index(uint64_t occupied) const noexcept {
+#ifdef USE_PEXT
+        return _pext_u64(occupied, mask);
+#else
+        return ((occupied & mask) * magic) >> shift;
+#endif
+    }
 
+    inline uint64_t lookup(uint64_t occupied) const noexcept {
+        return attacks[index(occupied)];
+    }
+};
 
-extern std::array<int, 64> rook_magic_offsets;
-extern std::array<int, 64> bishop_magic_offsets;
+static_assert(sizeof(MagicEntry) == 32, "MagicEntry must pack two squares per cache line");
 
+// Construidas al compilar, en memoria de solo lectura compartida entre procesos
+extern const std::array<MagicEntry, 64> rook_magic_entries;
+extern const std::array<MagicEntry, 64> bishop_magic_entries;
 
-extern std::vector<uint64_t> rook_magic_attack_table;
-extern std::vector<uint64_t> bishop_magic_attack_table;
+inline uint64_t rook_attacks(int sq, uint64_t occupied) noexcept {
+    return rook_magic_entries[sq].lookup(occupied);
+}
 
-// Function used to populate the tables of moves
-void generate_magic_bitboards();
+inline uint64_t bishop_attacks(int sq, uint64_t occupied) noexcept {
+    return bishop_magic_entries[sq].lookup(occupied);
+}
 
 #endif // MAGIC_BITBOARD_DATA_H
\ No newline at end of file
@@ -2,79 +2,105 @@
 
 #include "utils.h"
 #include "data.h"
-#include <algorithm>
-#include <vector>
-#include <iostream>
 #include <array>
 
-void generate_magic_bitboards() {
-    size_t current_rook_offset = 0;
-
+// Máscaras, desplazamientos y offsets de cada casilla, evaluados por el compilador
+template <uint64_t (*generate_mask)(int)>
+constexpr std::array<uint64_t, 64> generate_masks() {
+    std::array<uint64_t, 64> masks{};
+    for (int square = 0; square < 64; ++square) masks[square] = generate_mask(square);
+    return masks;
+}
+
+constexpr std::array<int, 64> generate_shifts(const std::array<uint64_t, 64>& masks) {
+    std::array<int, 64> shifts{};
+    for (int square = 0; square < 64; ++square) shifts[square] = 64 - __builtin_popcountll(masks[square]);
+    return shifts;
+}
+
+// Cada casilla ocupa 2^bits relevantes entradas consecutivas de la tabla
+constexpr std::array<int, 64> generate_offsets(const std::array<uint64_t, 64>& masks) {
+    std::array<int, 64> offsets{};
+    int current_offset = 0;
     for (int square = 0; square < 64; ++square) {
-        uint64_t mask = generate_rook_mask(square);
-        rook_masks[square] = mask;
-        
-        int num_relevant_bits = __builtin_popcountll(mask);
-
-        rook_magic_shifts[square] = 64 - num_relevant_bits;
-        rook_magic_offsets[square] = static_cast<int>(current_rook_offset);
-
-        std::vector<uint64_t> blocker_combinations = generate_blocker_combinations(mask);
-
-        rook_magic_attack_table.resize(current_rook_offset + blocker_combinations.size());
-
-        for (size_t i = 0; i < blocker_combinations.size(); ++i) {
-            uint64_t relevant_blockers = blocker_combinations[i];
-            
-            uint64_t index = (relevant_blockers * ROOK_MAGICS[square]) >> (64 - num_relevant_bits);
-
-            uint64_t actual_attacks = generate_raw_sliding_attacks(square, relevant_blockers, rook_directions);
-
-            rook_magic_attack_table[current_rook_offset + index] = actual_attacks;
-        }
-
-        current_rook_offset += blocker_combinations.size();
+        offsets[square] = current_offset;
+        current_offset += 1 << __builtin_popcountll(masks[square]);
     }
+    return offsets;
+}
 
-    size_t current_bishop_offset = 0;
-
-    for (int square = 0; square < 64; ++square) {
-        uint64_t mask = generate_bishop_mask(square);
-        bishop_masks[square] = mask;
+constexpr std::array<uint64_t, 64> rook_masks = generate_masks<generate_rook_mask>();
+constexpr std::array<uint64_t, 64> bishop_masks = generate_masks<generate_bishop_mask>();
 
-        int num_relevant_bits = __builtin_popcountll(mask);
 
-        bishop_magic_shifts[square] = 64 - num_relevant_bits;
-        bishop_magic_offsets[square] = static_cast<int>(current_bishop_offset);
+constexpr std::array<int, 64> rook_magic_shifts = generate_shifts(rook_masks);
+constexpr std::array<int, 64> bishop_magic_shifts = generate_shifts(bishop_masks);
 
-        std::vector<uint64_t> blocker_combinations = generate_blocker_combinations(mask);
 
-        bishop_magic_attack_table.resize(current_bishop_offset + blocker_combinations.size());
+constexpr std::array<int, 64> rook_magic_offsets = generate_offsets(rook_masks);
+constexpr std::array<int, 64> bishop_magic_offsets = generate_offsets(bishop_masks);
 
-        for (size_t i = 0; i < blocker_combinations.size(); ++i) {
-            uint64_t relevant_blockers = blocker_combinations[i];
-            
-            uint64_t index = (relevant_blockers * BISHOP_MAGICS[square]) >> bishop_magic_shifts[square];
-            uint64_t actual_attacks = generate_raw_sliding_attacks(square, relevant_blockers, bishop_directions);
+static_assert(rook_magic_offsets[63] + (1 << (64 - rook_magic_shifts[63])) == ROOK_ATTACK_TABLE_SIZE);
+static_assert(bishop_magic_offsets[63] + (1 << (64 - bishop_magic_shifts[63])) == BISHOP_ATTACK_TABLE_SIZE);
 
-            bishop_magic_attack_table[current_bishop_offset + index] = actual_attacks;
-        }
 
-        current_bishop_offset += blocker_combinations.size();
-    }
+// Las tablas de ataque son demasiado grandes para constexpr, se generan una vez con
+// attack_table_generator.cpp y se embeben; hay que regenerarlas si cambian los números mágicos
+constexpr std::array<uint64_t, ROOK_ATTACK_TABLE_SIZE> rook_magic_attack_table = {
+#include "rook_attacks.inc"
 };
 
-std::array<uint64_t, 64> rook_masks;
-std::array<uint64_t, 64> bishop_masks;
-
-
-std::array<int, 64> rook_magic_shifts;
-std::array<int, 64> bishop_magic_shifts;
-
+constexpr std::array<uint64_t, BISHOP_ATTACK_TABLE_SIZE> bishop_magic_attack_table = {
+#include "bishop_attacks.inc"
+};
 
-std::array<int, 64> rook_magic_offsets;
-std::array<int, 64> bishop_magic_offsets;
 
+#ifdef USE_PEXT
+// Reordena la tabla por índice pext: recorrer los subconjuntos de la máscara con
+// (sub - mask) & mask los visita en orden de pext creciente
+template <size_t N>
+constexpr std::array<uint64_t, N> to_pext_layout(const std::array<uint64_t, N>& magic_table,
+                                                 const std::array<uint64_t, 64>& masks,
+                                                 const std::array<uint64_t, 64>& magics,
+                                                 const std::array<int, 64>& shifts,
+                                                 const std::array<int, 64>& offsets) {
+    std::array<uint64_t, N> table{};
+    for (int square = 0; square < 64; ++square) {
+        uint64_t blockers = 0;
+        size_t pext_index = 0;
+        do {
+            uint64_t magic_index = (blockers * magics[square]) >> shifts[square];
+            table[offsets[square] + pext_index++] = magic_table[offsets[square] + magic_index];
+            blockers = (blockers - masks[square]) & masks[square];
+        } while (blockers);
+    }
+    return table;
+}
+
+constexpr std::array<uint64_t, ROOK_ATTACK_TABLE_SIZE> rook_attack_table =
+    to_pext_layout(rook_magic_attack_table, rook_masks, ROOK_MAGICS, rook_magic_shifts, rook_magic_offsets);
+constexpr std::array<uint64_t, BISHOP_ATTACK_TABLE_SIZE> bishop_attack_table =
+    to_pext_layout(bishop_magic_attack_table, bishop_masks, BISHOP_MAGICS, bishop_magic_shifts, bishop_magic_offsets);
+#else
+constexpr const std::array<uint64_t, ROOK_ATTACK_TABLE_SIZE>& rook_attack_table = rook_magic_attack_table;
+constexpr const std::array<uint64_t, BISHOP_ATTACK_TABLE_SIZE>& bishop_attack_table = bishop_magic_attack_table;
+#endif
+
+
+constexpr std::array<MagicEntry, 64> generate_entries(const std::array<uint64_t, 64>& masks,
+                                                      const std::array<uint64_t, 64>& magics,
+                                                      const std::array<int, 64>& shifts,
+                                                      const std::array<int, 64>& offsets,
+                                                      const uint64_t* attack_table) {
+    std::array<MagicEntry, 64> entries{};
+    for (int square = 0; square < 64; ++square) {
+        entries[square] = {masks[square], magics[square], attack_table + offsets[square],
+                           static_cast<uint32_t>(shifts[square])};
+    }
+    return entries;
+}
 
-std::vector<uint64_t> rook_magic_attack_table;
-std::vector<uint64_t> bishop_magic_attack_table;
\ No newline at end of file
+constexpr std::array<MagicEntry, 64> rook_magic_entries =
+    generate_entries(rook_masks, ROOK_MAGICS, rook_magic_shifts, rook_magic_offsets, rook_attack_table.data());
+constexpr std::array<MagicEntry, 64> bishop_magic_entries =
+    generate_entries(bishop_masks, BISHOP_MAGICS, bishop_magic_shifts, bishop_magic_offsets, bishop_attack_table.data());
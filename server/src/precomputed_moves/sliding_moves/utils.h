@@ -9,10 +9,58 @@
 #include <algorithm> // Para std::min
 #include <iostream>
 
-uint64_t generate_rook_mask(int square);
+// Las máscaras son constexpr: las tablas del motor se construyen al compilar
+constexpr uint64_t generate_rook_mask(int square) {
+    int rank = square / 8;
+    int file = square % 8;
+    uint64_t mask = 0ULL;
 
-uint64_t generate_bishop_mask(int square);
+    for (int f = 1; f < 7; ++f) {
+        if (f != file) { // Evita la propia posición de la torre
+            mask |= (1ULL << (rank * 8 + f));
+        }
+    }
 
+    for (int r = 1; r < 7; ++r) {
+        if (r != rank) { // Evita la propia posición de la torre
+            mask |= (1ULL << (r * 8 + file));
+        }
+    }
+
+    return mask;
+}
+
+
+constexpr uint64_t generate_bishop_mask(int square) {
+    int rank = square / 8;
+    int file = square % 8;
+    uint64_t mask = 0ULL;
+
+    // Diagonal ↘↖ (hacia la derecha-abajo y la izquierda-arriba, excluyendo los bordes)
+    // Hacia la esquina inferior derecha
+    for (int i = 1; i < std::min(8 - file, 8 - rank); ++i) { // Asegura que no va más allá del borde
+        mask |= (1ULL << ((rank + i) * 8 + (file + i)));
+    }
+    // Hacia la esquina superior izquierda
+    for (int i = 1; i < std::min(file + 1, rank + 1); ++i) { // Asegura que no va más allá del borde
+        mask |= (1ULL << ((rank - i) * 8 + (file - i)));
+    }
+
+    // Diagonal ↙↗ (hacia la izquierda-abajo y la derecha-arriba, excluyendo los bordes)
+    // Hacia la esquina inferior izquierda
+    for (int i = 1; i < std::min(file + 1, 8 - rank); ++i) { // Asegura que no va más allá del borde
+        mask |= (1ULL << ((rank + i) * 8 + (file - i)));
+    }
+    // Hacia la esquina superior derecha
+    for (int i = 1; i < std::min(8 - file, rank + 1); ++i) { // Asegura que no va más allá del borde
+        mask |= (1ULL << ((rank - i) * 8 + (file + i)));
+    }
+
+    return mask;
+}
+
+
+// Solo para los generadores de números mágicos y de tablas
 std::vector<uint64_t> generate_blocker_combinations(uint64_t mask);
 
 uint64_t generate_raw_sliding_attacks(int square, uint64_t occupancy,
@@ -0,0 +1,59 @@
+#pragma once
+#include "../game/Game.h"
+#include <array>
+#include <cstdint>
+
+// Two quiet moves per ply that produced a beta cutoff
+using KillerMoves = std::array<uint16_t, 2>;
+
+// History heuristic: [side][from][to], grows with depth^2 on quiet cutoffs
+using HistoryTable = std::array<std::array<std::array<int, 64>, 64>, 2>;
+
+// Hands out the moves of a node one at a time, best first:
+// hash move, captures and queen promotions by MVV-LVA, killers, quiets by history,
+// and last underpromotions and the captures that lose material by SEE.
+// The hash move is checked with Game::is_legal and returned before anything is
+// generated; the list is built only when the picker moves past it and each
+// stage is scored only when it is reached, so an early cutoff skips the rest of the work.
+class MovePicker {
+public:
+    // Main search
+    MovePicker(Game& game, uint16_t tt_move, const KillerMoves& killers, const HistoryTable& history);
+
+    // Quiescence: captures that do not lose material by SEE and queen promotions,
+    // every evasion when in check
+    explicit MovePicker(Game& game);
+
+    // Next move to search, 0 when there are none left
+    uint16_t next();
+
+    // Number of legal moves, valid once next() has gone past the hash move
+    inline int legal_moves() const noexcept { return moves.size(); }
+
+private:
+    enum Stage { TT_MOVE, GENERATE, SCORE_NOISY, NOISY, KILLERS, SCORE_QUIETS, QUIETS, BAD_NOISY, DONE };
+
+    Game& game;
+    const KillerMoves* killers;
+    const HistoryTable* history;
+    uint16_t tt_move;
+    bool quiescence;
+    bool prune_losing = false; // quiescence without check: losing captures are never returned
+
+    Stage stage = TT_MOVE;
+    MoveList moves;
+    std::array<int, MAX_LEGAL_MOVES> scores;
+    int current = 0;    // next unpicked move
+    int quiet_start = 0;
+    int bad_noisy = 0;  // losing captures are [bad_noisy, quiet_start)
+    int killer_idx = 0;
+
+    bool is_emitted_early(uint16_t move) const;
+    uint16_t pick_best(int end);
+};
+
+// Captures, promotions and en passant
+inline bool is_noisy(uint16_t move) {
+    MoveType type = move_kind(move);
+    return type == CAPTURE || type == PROMOTION || type == PROMOTION_CAPTURE || type == EN_PASSANT;
+}
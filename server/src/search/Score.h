@@ -0,0 +1,36 @@
+#pragma once
+#include "../constants/StaticData.h"
+#include <cstdint>
+
+// Search score in centipawns. Every value fits in int16 so it packs into the
+// transposition table; arithmetic is done in int.
+using Score = int32_t;
+
+constexpr Score SCORE_DRAW     = 0;
+constexpr Score SCORE_MATE     = 32000;
+constexpr Score SCORE_INFINITE = 32001;
+
+// Anything beyond this is a forced mate within the search horizon
+constexpr Score SCORE_MATE_IN_MAX_PLY = SCORE_MATE - MAX_PLY;
+
+// Mate scores count plies from the root, so shorter mates score higher
+constexpr Score mate_in(int ply)  { return SCORE_MATE - ply; }
+constexpr Score mated_in(int ply) { return -SCORE_MATE + ply; }
+
+constexpr bool is_mate_score(Score score) {
+    return score >= SCORE_MATE_IN_MAX_PLY || score <= -SCORE_MATE_IN_MAX_PLY;
+}
+
+// The table stores mate scores relative to the node, not the root, so an entry
+// stays valid when the same position is reached at a different ply
+constexpr Score score_to_tt(Score score, int ply) {
+    return score >= SCORE_MATE_IN_MAX_PLY  ? score + ply
+         : score <= -SCORE_MATE_IN_MAX_PLY ? score - ply
+                                           : score;
+}
+
+constexpr Score score_from_tt(Score score, int ply) {
+    return score >= SCORE_MATE_IN_MAX_PLY  ? score - ply
+         : score <= -SCORE_MATE_IN_MAX_PLY ? score + ply
+                                           : score;
+}
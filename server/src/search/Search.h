@@ -1,16 +1,121 @@
 #pragma once
 #include "../board_state/BoardState.h"
 #include "../game/Game.h"
+#include "MovePicker.h"
+#include "Score.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+// Limits for one enginego/go request, 0 means unlimited
+struct SearchLimits {
+    int depth = 0;
+    int64_t movetime = 0;   // milliseconds
+    uint64_t nodes = 0;
+
+    // Clock of each side (go wtime/btime/winc/binc/movestogo), milliseconds
+    int64_t time[2] = {0, 0};
+    int64_t inc[2] = {0, 0};
+    int movestogo = 0;
+    bool infinite = false;  // only "stop" ends the search
+    bool ponder = false;    // go ponder: no limit applies until ponderhit
+};
+
+constexpr int MAX_THREADS = 64;
+constexpr int HISTORY_MAX = 1 << 20;
 
 class Search {
+private:
+    // Shared with the Lazy SMP helper threads and the sessions, helpers never age it
+    std::shared_ptr<TranspositionTable> tt;
+    bool ages_table;
+    int num_threads = 1;
+
+    // Selectividad, se puede desactivar con setoption para comparar
+    bool null_move_enabled = true;
+    bool lmr_enabled = true;
+
+    // Helpers: raised by the main thread when it finishes. Main thread: "stop"
+    const std::atomic<bool>* abort_signal = nullptr;
+    const std::atomic<bool>* ponder_signal = nullptr; // raised while pondering, lowered by ponderhit
+    bool pondering_now = false;
+
+    // Per-request budget state
+    SearchLimits limits;
+    int64_t soft_time = 0; // no new iteration starts after this many ms
+    int64_t hard_time = 0; // the search is interrupted after this many ms
+    std::chrono::steady_clock::time_point start_time;
+    uint64_t nodes = 0;                                // this thread only
+    std::atomic<uint64_t>* node_total = nullptr;       // every thread of the request, added 1024 at a time
+    bool stopped = false;
+    bool can_stop = false; // false until the first iteration completes
+
+    // Ordenación de movimientos tranquilos
+    std::array<KillerMoves, MAX_PLY> killers{};
+    HistoryTable history{};
+
+    // Variante principal triangular: pv_table[ply] guarda la mejor línea desde ese ply
+    std::array<std::array<uint16_t, MAX_PLY + 1>, MAX_PLY + 1> pv_table{};
+    std::array<int, MAX_PLY + 1> pv_length{};
+
+    void update_pv(int ply, uint16_t move);
+    void report_iteration(std::ostream& out, int depth, Score score) const;
+
+    void update_quiet_stats(Color side, uint16_t move, int depth, int ply);
+    void age_history();
+
+    int64_t elapsed_ms() const;
+    void allocate_time(Color side);
+    bool pondering();
+    void check_limits();
+    uint64_t searched_nodes() const;
+
+    // Bucle de profundización compartido por el hilo principal y los auxiliares
+    uint16_t deepen(Game& game, int first_depth, int max_depth, std::ostream* info_out = nullptr);
+    void run_helper(Game& game, int first_depth, int max_depth, const std::atomic<bool>* abort,
+                    std::atomic<uint64_t>* total);
+
+    // Hace el movimiento, busca desde la perspectiva del rival y lo deshace
+    Score search_move(Game& game, uint16_t move, int depth, Score alpha, Score beta);
+
 public:
+    Search() : tt(std::make_shared<TranspositionTable>()), ages_table(true) {}
+    explicit Search(std::shared_ptr<TranspositionTable> shared_tt, bool ages_table = false)
+        : tt(std::move(shared_tt)), ages_table(ages_table) {}
+
+    // setoption handlers
+    void set_threads(int threads);
+    void set_null_move(bool enabled) { null_move_enabled = enabled; }
+    void set_lmr(bool enabled) { lmr_enabled = enabled; }
+    void copy_options(const Search& other) {
+        num_threads = other.num_threads;
+        null_move_enabled = other.null_move_enabled;
+        lmr_enabled = other.lmr_enabled;
+    }
+
+    // The search ends (once it has a move) when the signal is raised, not thread safe
+    void set_stop_signal(const std::atomic<bool>* signal) { abort_signal = signal; }
+    void set_ponder_signal(const std::atomic<bool>* signal) { ponder_signal = signal; }
+    void set_hash_size(size_t size_mb) { tt->resize(size_mb); }
+    void clear_hash() { tt->clear(); }
+    std::shared_ptr<TranspositionTable> shared_table() const { return tt; }
+
     int evaluate_board(const BoardState& board_state, Color sideToMove) const;
 
-    // Función Negamax con Poda Alfa-Beta
-    double negamax(Game& game, int depth, double alpha, double beta); // Recibe una referencia a Game
+    // Búsqueda de quietud sobre capturas y promociones
+    Score quiescence(Game& game, Score alpha, Score beta);
+
+    // Función Negamax con Poda Alfa-Beta, allow_null evita dos movimientos nulos seguidos
+    Score negamax(Game& game, int depth, Score alpha, Score beta, bool allow_null = true);
+
+    // Búsqueda en la raíz dentro de [alpha, beta], el mejor movimiento queda en pv_table[0][0]
+    Score find_best_move(Game& game, int depth, Score alpha, Score beta);
 
-    // Función principal para encontrar el mejor movimiento
-    uint16_t find_best_move(Game& game, int depth);
+    // Profundización iterativa, devuelve el mejor movimiento de la última iteración completa
+    // y escribe una línea "info" por iteración en info_out si se indica
+    uint16_t iterative_deepening(Game& game, const SearchLimits& search_limits, std::ostream* info_out = nullptr);
 
-    void engine_moves(Game& game);
+    void engine_moves(Game& game, const SearchLimits& search_limits = SearchLimits(), std::ostream& out = std::cout);
 };
\ No newline at end of file
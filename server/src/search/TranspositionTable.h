@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum Bound : uint8_t {
+    BOUND_NONE  = 0,
+    BOUND_UPPER = 1, // fail-low: score <= alpha
+    BOUND_LOWER = 2, // fail-high: score >= beta
+    BOUND_EXACT = 3,
+};
+
+// Decoded view of a slot, what probe() hands back to the search
+struct TTEntry {
+    uint64_t key;
+    int16_t score;   // Score, mate scores relative to this node
+    uint16_t move;
+    int8_t depth;
+    Bound bound;
+};
+
+// Lock-free slot shared by the search threads: the key is stored xor'ed with
+// the data word, so a slot torn by two concurrent writers fails verification
+// instead of returning mixed data.
+struct TTSlot {
+    std::atomic<uint64_t> key_xor_data;
+    std::atomic<uint64_t> data;
+};
+
+// 16 bytes per slot, four slots per 64-byte bucket
+struct alignas(64) TTBucket {
+    std::array<TTSlot, 4> slots;
+};
+
+static_assert(sizeof(TTSlot) == 16, "TTSlot must stay 16 bytes");
+static_assert(sizeof(TTBucket) == 64, "TTBucket must fill one cache line");
+
+class TranspositionTable {
+private:
+    std::vector<TTBucket> buckets;
+    uint64_t bucket_mask;
+
+    // Bumped by every search (the main game's and each session's, not the helper
+    // threads), entries keep the one they were stored in. Any older entry loses to
+    // a current one whatever its depth
+    std::atomic<uint8_t> generation{0};
+
+    inline TTBucket& bucket_for(uint64_t key) { return buckets[key & bucket_mask]; }
+    inline const TTBucket& bucket_for(uint64_t key) const { return buckets[key & bucket_mask]; }
+
+    static uint64_t pack(int score, uint16_t move, int depth, Bound bound, uint8_t entry_generation);
+    static TTEntry unpack(uint64_t key, uint64_t data);
+
+public:
+    static constexpr size_t DEFAULT_SIZE_MB = 16;
+
+    explicit TranspositionTable(size_t size_mb = DEFAULT_SIZE_MB) { resize(size_mb); }
+
+    // Size is rounded down to a power of two number of buckets, not thread safe
+    void resize(size_t size_mb);
+    void clear();
+
+    // Called once per go/enginego, before the search threads start
+    void new_search() { generation.fetch_add(1, std::memory_order_relaxed); }
+
+    // Safe to call concurrently from every search thread
+    bool probe(uint64_t key, TTEntry& entry) const;
+    void store(uint64_t key, int depth, int score, Bound bound, uint16_t move);
+};
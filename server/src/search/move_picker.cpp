@@ -0,0 +1,155 @@
+#include "MovePicker.h"
+#include <utility>
+
+MovePicker::MovePicker(Game& game, uint16_t tt_move, const KillerMoves& killers, const HistoryTable& history)
+    : game(game), killers(&killers), history(&history), tt_move(tt_move), quiescence(false) {}
+
+MovePicker::MovePicker(Game& game)
+    : game(game), killers(nullptr), history(nullptr), tt_move(0), quiescence(true) {}
+
+// Moves already handed out by the hash or killer stages
+bool MovePicker::is_emitted_early(uint16_t move) const {
+    if (move == tt_move) return true;
+    if (!killers) return false;
+    for (int i = 0; i < killer_idx; ++i) {
+        if ((*killers)[i] == move) return true;
+    }
+    return false;
+}
+
+// Selection step: moves the best scored move of [current, end) to current
+uint16_t MovePicker::pick_best(int end) {
+    while (current < end) {
+        int best = current;
+        for (int i = current + 1; i < end; ++i) {
+            if (scores[i] > scores[best]) best = i;
+        }
+        std::swap(moves[current], moves[best]);
+        std::swap(scores[current], scores[best]);
+
+        uint16_t move = moves[current++];
+        if (!is_emitted_early(move)) return move;
+    }
+    return 0;
+}
+
+uint16_t MovePicker::next() {
+    switch (stage) {
+        case TT_MOVE: {
+            // The hash move is verified on its own: when it cuts off, nothing is generated
+            stage = GENERATE;
+            if (tt_move != 0) {
+                if (game.is_legal(tt_move)) return tt_move;
+                tt_move = 0; // not legal here, hash collision
+            }
+            [[fallthrough]];
+        }
+
+        case GENERATE: {
+            // En quietud sin jaque solo interesan las capturas y promociones
+            if (quiescence && !game.in_check()) {
+                prune_losing = true;
+                game.generate_captures(moves);
+            } else {
+                game.generate_all_legal(moves);
+            }
+
+            // Noisy moves first, quiet moves after quiet_start
+            for (int i = 0; i < moves.size(); ++i) {
+                if (is_noisy(moves[i])) std::swap(moves[i], moves[quiet_start++]);
+            }
+
+            stage = SCORE_NOISY;
+            [[fallthrough]];
+        }
+
+        case SCORE_NOISY: {
+            // MVV-LVA: víctima más valiosa primero, atacante más barato después.
+            // Las capturas con atacante más valioso que la víctima pasan por SEE y,
+            // si pierden material, quedan con puntuación negativa ordenadas por SEE.
+            // Las subpromociones van con ellas: se prueban al final y en quietud se podan
+            const BoardState& board_state = game.get_board_state();
+            for (int i = 0; i < quiet_start; ++i) {
+                int from_sq = (moves[i] >> 6) & 0x3F;
+                int to_sq = moves[i] & 0x3F;
+                MoveType type = move_kind(moves[i]);
+
+                Piece victim = board_state.piece_at(to_sq);
+                int victim_value = victim == NO_PIECE ? 0 : PIECE_BASE_VALUE[board_state.getType(victim)];
+                if (type == EN_PASSANT) victim_value = PIECE_BASE_VALUE[PAWN];
+
+                if (is_promotion(moves[i]) && promotion_piece(moves[i]) != QUEEN) {
+                    scores[i] = PIECE_BASE_VALUE[promotion_piece(moves[i])] - PIECE_BASE_VALUE[QUEEN];
+                    continue;
+                }
+                if (is_promotion(moves[i])) victim_value += PIECE_BASE_VALUE[QUEEN];
+
+                int attacker_value = PIECE_BASE_VALUE[board_state.getType(board_state.piece_at(from_sq))];
+                scores[i] = victim_value * 16 - attacker_value / 16;
+
+                if (type == CAPTURE && attacker_value > victim_value) {
+                    int see = board_state.see(moves[i]);
+                    if (see < 0) scores[i] = see;
+                }
+            }
+            stage = NOISY;
+            [[fallthrough]];
+        }
+
+        case NOISY: {
+            uint16_t move = pick_best(quiet_start);
+            if (move && scores[current - 1] >= 0) return move;
+
+            // Solo quedan capturas perdedoras: después de las tranquilas, o nunca en quietud
+            bad_noisy = move ? current - 1 : quiet_start;
+            if (prune_losing) {
+                stage = DONE;
+                return 0;
+            }
+            stage = killers ? KILLERS : SCORE_QUIETS;
+            return next();
+        }
+
+        case KILLERS: {
+            // A killer is only played if it is a quiet move legal in this position
+            while (killer_idx < 2) {
+                uint16_t killer = (*killers)[killer_idx++];
+                if (killer == 0 || killer == tt_move) continue;
+                for (int i = quiet_start; i < moves.size(); ++i) {
+                    if (moves[i] == killer) return killer;
+                }
+            }
+            stage = SCORE_QUIETS;
+            [[fallthrough]];
+        }
+
+        case SCORE_QUIETS: {
+            Color side = game.get_side_to_move();
+            for (int i = quiet_start; i < moves.size(); ++i) {
+                scores[i] = history ? (*history)[side][(moves[i] >> 6) & 0x3F][moves[i] & 0x3F] : 0;
+            }
+            current = quiet_start;
+            stage = QUIETS;
+            [[fallthrough]];
+        }
+
+        case QUIETS: {
+            uint16_t move = pick_best(moves.size());
+            if (move) return move;
+            current = bad_noisy;
+            stage = BAD_NOISY;
+            [[fallthrough]];
+        }
+
+        case BAD_NOISY: {
+            uint16_t move = pick_best(quiet_start);
+            if (move) return move;
+            stage = DONE;
+            [[fallthrough]];
+        }
+
+        case DONE:
+            return 0;
+    }
+    return 0;
+}
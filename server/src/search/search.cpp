@@ -1,188 +1,510 @@
 #include "Search.h"
 #include <algorithm> // Para std::max
-#include <limits> 
+#include <thread>
+#include <vector>
 
-// Función principal que encuentra el mejor movimiento
-uint16_t Search::find_best_move(Game& game, int depth) {
+// Búsqueda en la raíz: PVS dentro de la ventana de aspiración
+Score Search::find_best_move(Game& game, int depth, Score alpha, Score beta) {
+    const int ply = game.get_ply();
+    const Score alpha_orig = alpha;
     uint16_t best_move = 0;
-    double best_eval = -std::numeric_limits<double>::infinity();
-    double alpha = -std::numeric_limits<double>::infinity();
-    double beta = std::numeric_limits<double>::infinity();
+    Score best_eval = -SCORE_INFINITE;
+    pv_length[ply] = ply;
 
-    // Obtener todas las piezas del jugador actual
-    uint64_t friendly_bb = game.get_board_state().color_bb(game.get_side_to_move());
-    
-    // Iterar sobre todas las piezas del jugador actual
-    while (friendly_bb) {
-        int from_sq = __builtin_ctzll(friendly_bb);
-        friendly_bb &= friendly_bb - 1;
-        // Obtener movimientos legales para esta pieza (ya ordenados por prioridad)
-        std::vector<uint16_t> legal_moves = game.get_legal_moves(from_sq);
+    // El movimiento de la tabla de transposición se prueba primero
+    TTEntry entry;
+    uint16_t tt_move = tt->probe(game.get_key(), entry) ? entry.move : 0;
+    MovePicker picker(game, tt_move, killers[ply], history);
+    int moves_searched = 0;
+
+    // Procesar cada movimiento
+    while (uint16_t move = picker.next()) {
+        Score eval;
+        if (moves_searched++ == 0) {
+            eval = search_move(game, move, depth, alpha, beta);
+        } else {
+            // Ventana nula: solo se repite con ventana completa si puede mejorar alfa
+            eval = search_move(game, move, depth, alpha, alpha + 1);
+            if (eval > alpha && eval < beta && !stopped) eval = search_move(game, move, depth, alpha, beta);
+        }
+        if (stopped) return best_eval;
         
-        // Procesar cada movimiento
-        for (uint16_t move : legal_moves) {
-            // Hacer el movimiento
-            game.make_move(move);
-            
-            // Cambiar variables de estado
-            game.changeTurn();
-            game.increase_ply();
-            
-            // Llamada recursiva (negamax desde perspectiva del oponente)
-            double eval = -negamax(game, depth - 1, -beta, -alpha);
-            
-            // Revertir el cambio antes de revertir movimiento
-            game.decrease_ply();
-            game.changeTurn();
-            
-            // Deshacer el movimiento
-            game.unmake_move();
-            
-            // Actualizar el mejor movimiento
-            if (eval > best_eval) {
-                best_eval = eval;
-                best_move = move;
-            }
-            
-            // Actualizar alfa
-            alpha = std::max(alpha, eval);
-            
-            // Poda alfa-beta (aunque es menos común en el nodo raíz)
-            if (beta <= alpha) {
-                break; // Poda beta
-            }
+        // Actualizar el mejor movimiento
+        if (eval > best_eval) {
+            best_eval = eval;
+            best_move = move;
         }
         
-        // Si encontramos una poda, no necesitamos revisar más piezas
-        if (beta <= alpha) {
-            break;
+        if (eval > alpha) {
+            alpha = eval;
+            update_pv(ply, move);
         }
+        if (alpha >= beta) break;
+    }
+
+    if (best_move != 0) {
+        Bound bound = best_eval <= alpha_orig ? BOUND_UPPER
+                    : best_eval >= beta       ? BOUND_LOWER
+                                              : BOUND_EXACT;
+        tt->store(game.get_key(), depth, score_to_tt(best_eval, ply), bound, best_move);
     }
     
-    return best_move;
+    return best_eval;
 }
 
-double Search::negamax(Game& game, int depth, double alpha, double beta) {
-    // Caso base: profundidad 0 o fin del juego
-    if (depth == 0 || game.detect_game_over()) {
-        // Si es mate/tablas, manejar puntuaciones especiales
-        if (game.detect_game_over()) {
-            GameEvent event = game.get_game_event();
-            if (event == CHECKMATE) {
-                // Mate para el jugador actual es muy malo (-infinito)
-                // Usar -10000 + depth para preferir mates más largos
-                return -10000 + depth;
-            } else if (event == STALEMATE) {
-                // Tablas = 0
-                return 0;
-            }
+Score Search::search_move(Game& game, uint16_t move, int depth, Score alpha, Score beta) {
+    // Hacer el movimiento
+    game.make_move(move);
+    
+    // Cambiar variables de estado
+    game.changeTurn();
+    game.increase_ply();
+    
+    // Llamada recursiva (negamax desde perspectiva del oponente)
+    Score eval = -negamax(game, depth - 1, -beta, -alpha);
+    
+    // Revertir el cambio antes de revertir movimiento
+    game.decrease_ply();
+    game.changeTurn();
+    
+    // Deshacer el movimiento
+    game.unmake_move();
+
+    return eval;
+}
+
+Score Search::negamax(Game& game, int depth, Score alpha, Score beta, bool allow_null) {
+    // Revisar el presupuesto de tiempo/nodos cada 1024 nodos
+    if ((++nodes & 1023) == 0) check_limits();
+    if (stopped) return 0;
+
+    const int ply = game.get_ply();
+    pv_length[ply] = ply;
+
+    // Tablas por repetición o regla de los 50 movimientos, nunca en la raíz: hay que devolver una jugada
+    if (ply > 0 && game.is_draw()) return SCORE_DRAW;
+
+    // Caso base: profundidad 0, se resuelven las capturas pendientes
+    if (depth == 0) {
+        return quiescence(game, alpha, beta);
+    }
+
+    // Consultar la tabla de transposición
+    const uint64_t key = game.get_key();
+    const Score alpha_orig = alpha;
+    const bool pv_node = beta - alpha > 1;
+    uint16_t tt_move = 0;
+
+    // En nodos PV no se corta por la tabla: la variante principal se llena al volver de los hijos
+    TTEntry entry;
+    if (tt->probe(key, entry)) {
+        if (entry.depth >= depth && !pv_node) {
+            Score tt_score = score_from_tt(entry.score, ply);
+            if (entry.bound == BOUND_EXACT) return tt_score;
+            if (entry.bound == BOUND_LOWER) alpha = std::max(alpha, tt_score);
+            if (entry.bound == BOUND_UPPER) beta = std::min(beta, tt_score);
+            if (alpha >= beta) return tt_score;
         }
-        
-        // Evaluación normal del tablero
-        return evaluate_board(game.get_board_state(), game.get_side_to_move());
+        tt_move = entry.move;
     }
+
+    const bool in_check = game.in_check();
+
+    // Movimiento nulo: si pasando el turno el rival sigue sin llegar a beta, se poda.
+    // Con solo peones y rey el zugzwang es habitual y pasar no es una cota fiable
+    if (null_move_enabled && allow_null && !pv_node && !in_check && depth >= NULL_MOVE_MIN_DEPTH
+        && beta < SCORE_MATE_IN_MAX_PLY
+        && game.get_board_state().non_pawn_pieces(game.get_side_to_move())
+        && evaluate_board(game.get_board_state(), game.get_side_to_move()) >= beta) {
+        int reduction = depth > 6 ? 3 : 2;
+
+        game.make_null_move();
+        game.changeTurn();
+        game.increase_ply();
+
+        Score eval = -negamax(game, std::max(depth - 1 - reduction, 0), -beta, -beta + 1, false);
+
+        game.decrease_ply();
+        game.changeTurn();
+        game.unmake_null_move();
+
+        if (stopped) return 0;
+        // Un mate encontrado tras pasar no es real, se devuelve beta
+        if (eval >= beta) return is_mate_score(eval) ? beta : eval;
+    }
+
+    MovePicker picker(game, tt_move, killers[ply], history);
     
-    double max_eval = -std::numeric_limits<double>::infinity();
-    
-    // Obtener todas las piezas del jugador actual
-    uint64_t friendly_bb = game.get_board_state().color_bb(game.get_side_to_move());
+    Score max_eval = -SCORE_INFINITE;
+    uint16_t best_move = 0;
+    int moves_searched = 0;
     
-    // Iterar sobre todas las piezas del jugador actual
-    while (friendly_bb) {
-        int from_sq = __builtin_ctzll(friendly_bb);
-        friendly_bb &= friendly_bb - 1;
-        // Obtener movimientos legales para esta pieza (ya ordenados por prioridad)
-        std::vector<uint16_t> legal_moves = game.get_legal_moves(from_sq);
-        
-        // Procesar cada movimiento
-        for (uint16_t move : legal_moves) {
-            // Hacer el movimiento
-            game.make_move(move);
-            // Cambiar variables de estado
-            game.changeTurn();
-            game.increase_ply();
-            
-            // Llamada recursiva (negamax)
-            double eval = -negamax(game, depth - 1, -beta, -alpha);
-            
-            // Revertir el cambio antes de revertir movimiento
-            game.changeTurn();
-            game.decrease_ply();
-
-            // Deshacer el movimiento
-            game.unmake_move();
-            
-            // Actualizar la mejor evaluación
-            max_eval = std::max(max_eval, eval);
-            
-            // Actualizar alfa
-            alpha = std::max(alpha, eval);
-            
-            // Poda alfa-beta
-            if (beta <= alpha) {
-                break; // Poda beta
+    // Procesar cada movimiento, el picker los entrega de mejor a peor
+    while (uint16_t move = picker.next()) {
+        Score eval;
+        if (moves_searched++ == 0) {
+            eval = search_move(game, move, depth, alpha, beta);
+        } else {
+            // LMR: los movimientos tranquilos tardíos se buscan primero con menos profundidad
+            int reduction = 0;
+            if (lmr_enabled && depth >= LMR_MIN_DEPTH && moves_searched > LMR_MIN_MOVES && !in_check
+                && !is_noisy(move) && move != killers[ply][0] && move != killers[ply][1]) {
+                reduction = std::min(moves_searched > 2 * LMR_MIN_MOVES ? 2 : 1, depth - 2);
             }
+
+            // PVS: se espera que el primer movimiento sea el mejor, el resto se refuta con ventana nula
+            eval = search_move(game, move, depth - reduction, alpha, alpha + 1);
+            if (reduction && eval > alpha && !stopped) eval = search_move(game, move, depth, alpha, alpha + 1);
+            if (eval > alpha && eval < beta && !stopped) eval = search_move(game, move, depth, alpha, beta);
+        }
+        if (stopped) return 0;
+        
+        // Actualizar la mejor evaluación
+        if (eval > max_eval) {
+            max_eval = eval;
+            best_move = move;
         }
         
-        // Si encontramos una poda, no necesitamos revisar más piezas
+        // Actualizar alfa y la variante principal
+        if (eval > alpha) {
+            alpha = eval;
+            update_pv(ply, move);
+        }
+        
+        // Poda alfa-beta
         if (beta <= alpha) {
-            break;
+            if (!is_noisy(move)) update_quiet_stats(game.get_side_to_move(), move, depth, ply);
+            break; // Poda beta
         }
     }
+
+    // Sin movimientos legales: mate o ahogado
+    if (moves_searched == 0) {
+        // El mate cuenta plies desde la raíz: se prefieren los mates más cortos
+        return in_check ? mated_in(ply) : SCORE_DRAW;
+    }
+
+    Bound bound = max_eval <= alpha_orig ? BOUND_UPPER
+                : max_eval >= beta       ? BOUND_LOWER
+                                         : BOUND_EXACT;
+    tt->store(key, depth, score_to_tt(max_eval, ply), bound, best_move);
     
     return max_eval;
 }
 
 
-int Search::evaluate_board(const BoardState& board_state, Color sideToMove) const {
-    int score = 0;
-    
-    uint64_t occupied_bb = board_state.occupied();
-    while (occupied_bb) {
-        int sq = __builtin_ctzll(occupied_bb);
-        Piece pc = board_state.piece_at(sq);
-        Type type = board_state.getType(pc); // Asumiendo que getType(pc) devuelve el tipo 0-5
-
-        // Calcula el valor de la pieza en su casilla
-        int piece_value = PIECE_BASE_VALUE[type] + get_table_by_piece(pc)[sq];
-
-        // Si la pieza es blanca, suma. Si es negra, resta.
-        if (colorOf(pc) == WHITE) {
-            score += piece_value;
-        } else {
-            score -= piece_value;
+// Búsqueda de quietud: solo capturas y promociones hasta que la posición se calma
+Score Search::quiescence(Game& game, Score alpha, Score beta) {
+    if ((++nodes & 1023) == 0) check_limits();
+    if (stopped) return 0;
+
+    const BoardState& board_state = game.get_board_state();
+    const bool in_check = game.in_check();
+    Score best_eval = -SCORE_INFINITE;
+    Score stand_pat = 0;
+
+    // Stand-pat: sin jaque, el bando puede quedarse con la evaluación estática
+    if (!in_check) {
+        stand_pat = evaluate_board(board_state, game.get_side_to_move());
+        if (stand_pat >= beta) return stand_pat;
+
+        // Ni capturando una dama se llega a alfa
+        if (stand_pat + PIECE_BASE_VALUE[QUEEN] + DELTA_MARGIN < alpha) return stand_pat;
+
+        best_eval = stand_pat;
+        alpha = std::max(alpha, stand_pat);
+    }
+
+    if (game.get_ply() >= MAX_PLY - 1) {
+        return evaluate_board(board_state, game.get_side_to_move());
+    }
+
+    // En jaque se buscan todas las evasiones; sin jaque el picker ya descarta las capturas perdedoras por SEE
+    MovePicker picker(game);
+
+    while (uint16_t move = picker.next()) {
+        MoveType type = move_kind(move);
+
+        // Delta pruning: la captura no alcanza alfa ni con margen
+        if (!in_check && !is_promotion(move)) {
+            Piece victim = board_state.piece_at(move & 0x3F);
+            int victim_value = type == EN_PASSANT ? PIECE_BASE_VALUE[PAWN] : PIECE_BASE_VALUE[board_state.getType(victim)];
+            if (stand_pat + victim_value + DELTA_MARGIN <= alpha) continue;
         }
-        
-        occupied_bb &= occupied_bb - 1; // Avanza al siguiente bit
+
+        game.make_move(move);
+        game.changeTurn();
+        game.increase_ply();
+
+        Score eval = -quiescence(game, -beta, -alpha);
+
+        game.decrease_ply();
+        game.changeTurn();
+        game.unmake_move();
+
+        if (stopped) return 0;
+
+        best_eval = std::max(best_eval, eval);
+        alpha = std::max(alpha, eval);
+        if (alpha >= beta) break;
     }
 
+    if (in_check && picker.legal_moves() == 0) return mated_in(game.get_ply());
+
+    return best_eval;
+}
+
+
+// La línea del hijo pasa a este ply detrás del movimiento
+void Search::update_pv(int ply, uint16_t move) {
+    pv_table[ply][ply] = move;
+    for (int i = ply + 1; i < pv_length[ply + 1]; ++i) pv_table[ply][i] = pv_table[ply + 1][i];
+    pv_length[ply] = pv_length[ply + 1];
+}
+
+// "info depth X score cp Y nodes N nps M pv ...", mates as "score mate N" in moves
+void Search::report_iteration(std::ostream& out, int depth, Score score) const {
+    int64_t ms = elapsed_ms();
+    uint64_t total = searched_nodes();
+    uint64_t nps = ms > 0 ? total * 1000 / ms : total * 1000;
+
+    out << "info depth " << depth << " score ";
+    if (is_mate_score(score)) {
+        out << "mate " << (score > 0 ? (SCORE_MATE - score + 1) / 2 : -(SCORE_MATE + score) / 2);
+    } else {
+        out << "cp " << score;
+    }
+    out << " nodes " << total << " nps " << nps << " pv";
+    for (int i = 0; i < pv_length[0]; ++i) out << " " << move_to_string(pv_table[0][i]);
+    out << std::endl; // the go thread's stream writes every line as it comes
+}
+
+
+// Un movimiento tranquilo que corta se vuelve killer de su ply y gana historia
+void Search::update_quiet_stats(Color side, uint16_t move, int depth, int ply) {
+    if (killers[ply][0] != move) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+
+    int& entry = history[side][(move >> 6) & 0x3F][move & 0x3F];
+    entry += depth * depth;
+
+    // Mantiene los valores acotados sin perder el orden relativo
+    if (entry > HISTORY_MAX) age_history();
+}
+
+void Search::age_history() {
+    for (auto& from_table : history)
+        for (auto& to_table : from_table)
+            for (int& value : to_table) value /= 2;
+}
+
+
+int Search::evaluate_board(const BoardState& board_state, Color sideToMove) const {
+    // Material + PSQ se mantiene incrementalmente en BoardState
+    int score = board_state.psq();
+
     // Devuelve la puntuación desde la perspectiva del jugador actual.
     return (sideToMove == WHITE) ? score : -score;
 }
 
 
-void Search::engine_moves(Game& game) {
-    // Depth of 5 is the max by now, works fine
-    uint16_t best = find_best_move(game, MAX_DEPTH);
+int64_t Search::elapsed_ms() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_time).count();
+}
 
-    game.make_move(best);
-    game.stream_move_data(best);
-    
-    // later we must implement an heuristic for promotion
-    if (game.get_promotion_sq() != NO_SQ) {
-        Piece promotion_pc = game.get_board_state().promote(game.get_promotion_sq()); // promote to queen by default
-        std::cout << "promotion_pc " << static_cast<int>(promotion_pc) << std::endl;
-        game.set_promotion_sq(NO_SQ);
+// Nodes of every thread: the shared total plus the ones this thread has not added yet
+uint64_t Search::searched_nodes() const {
+    if (!node_total) return nodes;
+    return node_total->load(std::memory_order_relaxed) + (nodes & 1023);
+}
+
+// Presupuesto blando/duro: entre iteraciones se respeta el blando, el duro corta la búsqueda
+void Search::allocate_time(Color side) {
+    soft_time = 0;
+    hard_time = 0;
+
+    if (limits.infinite) return;
+
+    if (limits.movetime) {
+        soft_time = limits.movetime / 2; // la siguiente iteración no terminaría
+        hard_time = limits.movetime;
+        return;
     }
 
-    // TODO: implemente stream data when engine promotes
+    if (limits.time[side] <= 0) return;
 
-    game.changeTurn();
+    int64_t usable = std::max<int64_t>(limits.time[side] - MOVE_OVERHEAD_MS, 1);
+    int moves_to_go = limits.movestogo > 0 ? limits.movestogo : DEFAULT_MOVES_TO_GO;
+
+    soft_time = usable / moves_to_go + limits.inc[side] * 3 / 4;
+    hard_time = std::min(soft_time * 3, usable * 3 / 4);
+    soft_time = std::max<int64_t>(std::min(soft_time, hard_time), 1);
+    hard_time = std::max<int64_t>(hard_time, 1);
+}
+
+// Pensando en el tiempo del rival solo "stop" termina; con ponderhit empieza a correr el reloj
+bool Search::pondering() {
+    if (!pondering_now) return false;
+    if (ponder_signal && ponder_signal->load(std::memory_order_relaxed)) return true;
+
+    pondering_now = false;
+    start_time = std::chrono::steady_clock::now();
+    return false;
+}
+
+// Called every 1024 nodes of this thread, which first adds them to the shared total
+void Search::check_limits() {
+    if (node_total) node_total->fetch_add(1024, std::memory_order_relaxed);
+
+    // Hasta completar la primera iteración no hay movimiento que devolver
+    if (!can_stop) return;
+
+    if (abort_signal && abort_signal->load(std::memory_order_relaxed)) {
+        stopped = true;
+        return;
+    }
+
+    if (pondering()) return;
+
+    if ((limits.nodes && searched_nodes() >= limits.nodes) ||
+        (hard_time && elapsed_ms() >= hard_time)) {
+        stopped = true;
+    }
+}
+
+void Search::set_threads(int threads) {
+    num_threads = std::clamp(threads, 1, MAX_THREADS);
+}
 
+uint16_t Search::deepen(Game& game, int first_depth, int max_depth, std::ostream* info_out) {
+    uint16_t best_move = 0;
+    Score score = 0;
+
+    for (int depth = first_depth; depth <= max_depth; ++depth) {
+        // Ventana de aspiración alrededor de la puntuación anterior, se abre al fallar
+        Score delta = ASPIRATION_WINDOW;
+        Score alpha = -SCORE_INFINITE;
+        Score beta = SCORE_INFINITE;
+        if (depth >= ASPIRATION_DEPTH) {
+            alpha = std::max(score - delta, -SCORE_INFINITE);
+            beta = std::min(score + delta, SCORE_INFINITE);
+        }
+
+        while (true) {
+            Score result = find_best_move(game, depth, alpha, beta);
+            if (stopped) break;
+
+            if (result <= alpha && alpha > -SCORE_INFINITE) {
+                alpha = std::max(result - delta, -SCORE_INFINITE);
+            } else if (result >= beta && beta < SCORE_INFINITE) {
+                beta = std::min(result + delta, SCORE_INFINITE);
+            } else {
+                score = result;
+                break;
+            }
+            delta *= 2;
+        }
+
+        // Una iteración interrumpida no es fiable, se descarta
+        if (stopped) break;
+
+        // Sin movimientos legales no hay variante principal (la raíz es el ply 0)
+        if (pv_length[0] == 0) break;
+
+        best_move = pv_table[0][0];
+        can_stop = true;
+        if (info_out) report_iteration(*info_out, depth, score);
+
+        if (pondering()) continue; // el presupuesto cuenta desde ponderhit
+        if (soft_time && elapsed_ms() >= soft_time) break;
+        if (limits.nodes && searched_nodes() >= limits.nodes) break;
+    }
+
+    return best_move;
+}
+
+// Lazy SMP: each helper searches its own copy of the game and only talks to
+// the main thread through the shared transposition table
+void Search::run_helper(Game& game, int first_depth, int max_depth, const std::atomic<bool>* abort,
+                        std::atomic<uint64_t>* total) {
+    abort_signal = abort;
+    node_total = total;
+    start_time = std::chrono::steady_clock::now();
+    deepen(game, first_depth, max_depth);
+}
+
+uint16_t Search::iterative_deepening(Game& game, const SearchLimits& search_limits, std::ostream* info_out) {
+    limits = search_limits;
+    start_time = std::chrono::steady_clock::now();
+    nodes = 0;
+    stopped = false;
+    can_stop = false;
+    pondering_now = limits.ponder;
+    allocate_time(game.get_side_to_move());
+
+    // Los killers son de la posición anterior; la historia se conserva a medias
+    for (KillerMoves& ply_killers : killers) ply_killers.fill(0);
+    age_history();
+    if (ages_table) tt->new_search(); // entries of earlier searches become replaceable
+
+    // Sin presupuesto se mantiene la profundidad fija de siempre
+    int max_depth = limits.depth;
+    if (max_depth <= 0) {
+        max_depth = (hard_time || limits.nodes || limits.infinite || limits.ponder) ? MAX_PLY - 1 : MAX_DEPTH;
+    }
+    max_depth = std::min(max_depth, MAX_PLY - 1);
+
+    // Odd helpers start one ply deeper so the threads don't walk in lockstep.
+    // Node limits and info lines count the nodes of every thread
+    std::atomic<bool> helpers_abort{false};
+    std::atomic<uint64_t> total_nodes{0};
+    std::vector<std::thread> helpers;
+    node_total = &total_nodes;
+
+    for (int i = 1; i < num_threads; ++i) {
+        helpers.emplace_back([shared_tt = tt, helper_game = game, null_move = null_move_enabled, lmr = lmr_enabled,
+                              &helpers_abort, &total_nodes, max_depth, i]() mutable {
+            Search helper(shared_tt);
+            helper.set_null_move(null_move);
+            helper.set_lmr(lmr);
+            helper.run_helper(helper_game, 1 + (i % 2), max_depth, &helpers_abort, &total_nodes);
+        });
+    }
+
+    uint16_t best_move = deepen(game, 1, max_depth, info_out);
+
+    helpers_abort.store(true, std::memory_order_relaxed);
+    for (std::thread& helper : helpers) helper.join();
+    node_total = nullptr;
+
+    return best_move;
+}
+
+void Search::engine_moves(Game& game, const SearchLimits& search_limits, std::ostream& out) {
+    // Nothing to play once the game is over (mate, stalemate or a draw), report it again
     uint64_t threats = game.detect_check();
+    if (game.detect_game_over()) {
+        out << "event_data " << threats << std::endl;
+        out << "event " << eventMessages[game.get_game_event()] << std::endl;
+        out << "nextturn\n";
+        return;
+    }
+
+    uint16_t best = iterative_deepening(game, search_limits, &out);
+
+    // The search picked the promotion piece too, stream_move_data reports it
+    game.make_game_move(best);
+    game.stream_move_data(best, out);
+
+    game.changeTurn();
+
+    threats = game.detect_check();
     game.detect_game_over();
 
-    std::cout << "event_data " << threats << std::endl;
-    std::cout << "event " << eventMessages[game.get_game_event()] << std::endl;
-    std::cout << "nextturn\n";
+    out << "event_data " << threats << std::endl;
+    out << "event " << eventMessages[game.get_game_event()] << std::endl;
+    out << "nextturn\n";
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "TranspositionTable.h"
+
+// Data word layout: unused (8) | generation (8) | score (16) | move (16) | depth (8) | bound (8)
+uint64_t TranspositionTable::pack(int score, uint16_t move, int depth, Bound bound, uint8_t entry_generation) {
+    return (static_cast<uint64_t>(entry_generation) << 48)
+         | (static_cast<uint64_t>(static_cast<uint16_t>(score)) << 32)
+         | (static_cast<uint64_t>(move) << 16)
+         | (static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 8)
+         | static_cast<uint64_t>(bound);
+}
+
+TTEntry TranspositionTable::unpack(uint64_t key, uint64_t data) {
+    return {
+        key,
+        static_cast<int16_t>(static_cast<uint16_t>(data >> 32)),
+        static_cast<uint16_t>(data >> 16),
+        static_cast<int8_t>(static_cast<uint8_t>(data >> 8)),
+        static_cast<Bound>(data & 0xFF)
+    };
+}
+
+void TranspositionTable::resize(size_t size_mb) {
+    size_t num_buckets = 1;
+    size_t max_buckets = (size_mb * 1024 * 1024) / sizeof(TTBucket);
+
+    while (num_buckets * 2 <= max_buckets) num_buckets *= 2;
+
+    buckets = std::vector<TTBucket>(num_buckets);
+    bucket_mask = num_buckets - 1;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    for (TTBucket& bucket : buckets) {
+        for (TTSlot& slot : bucket.slots) {
+            slot.key_xor_data.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    const TTBucket& bucket = bucket_for(key);
+
+    for (const TTSlot& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t key_xor_data = slot.key_xor_data.load(std::memory_order_relaxed);
+
+        if ((key_xor_data ^ data) == key && (data & 0xFF) != BOUND_NONE) {
+            entry = unpack(key, data);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Searches since the entry was stored, 0 for the current one (wraps after 256)
+static inline int entry_age(uint64_t data, uint8_t current) {
+    return static_cast<uint8_t>(current - static_cast<uint8_t>(data >> 48));
+}
+
+void TranspositionTable::store(uint64_t key, int depth, int score, Bound bound, uint16_t move) {
+    TTBucket& bucket = bucket_for(key);
+    uint8_t current = generation.load(std::memory_order_relaxed);
+    TTSlot* replace = nullptr;
+    int replace_value = 0;
+
+    // Same position: keep the deeper result of this search unless the new one is exact
+    for (TTSlot& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t key_xor_data = slot.key_xor_data.load(std::memory_order_relaxed);
+        if ((key_xor_data ^ data) != key || (data & 0xFF) == BOUND_NONE) continue;
+
+        TTEntry old = unpack(key, data);
+        if (entry_age(data, current) == 0 && depth < old.depth && bound != BOUND_EXACT) return;
+        if (move == 0) move = old.move; // keep the old best move
+        replace = &slot;
+        break;
+    }
+
+    // Otherwise take an empty slot or evict the least useful entry: the oldest
+    // generation first (depth is at most 127, so age outweighs it), then the shallowest
+    if (!replace) {
+        for (TTSlot& slot : bucket.slots) {
+            uint64_t data = slot.data.load(std::memory_order_relaxed);
+            if ((data & 0xFF) == BOUND_NONE) {
+                replace = &slot;
+                break;
+            }
+
+            int slot_depth = static_cast<int8_t>(static_cast<uint8_t>(data >> 8));
+            int slot_value = slot_depth - 256 * entry_age(data, current);
+            if (!replace || slot_value < replace_value) {
+                replace = &slot;
+                replace_value = slot_value;
+            }
+        }
+    }
+
+    uint64_t data = pack(score, move, depth, bound, current);
+    replace->key_xor_data.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "../game/Game.h"
+#include "../search/Search.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// One game hosted by the multi-session engine
+struct Session {
+    std::string id;
+    Game game;
+    Search search;
+    std::atomic<bool> stop_signal{false}; // raised by "session <id> stop" or "close"
+
+    // Guarded by the pool mutex. Commands are numbered as they are submitted; a stop
+    // reaches every command up to stop_sequence, the running one and those still queued
+    std::deque<std::pair<uint64_t, std::string>> pending;
+    uint64_t last_sequence = 0;
+    uint64_t stop_sequence = 0;
+    bool scheduled = false;
+
+    // Starts with the options of the given search and shares its table
+    Session(std::string session_id, const Search& defaults)
+        : id(std::move(session_id)), search(defaults.shared_table(), true) {
+        search.copy_options(defaults);
+        search.set_stop_signal(&stop_signal);
+    }
+};
+
+// Hosts many games in one process. The attack tables are process globals, so
+// every session reads the same copy, and all sessions share one transposition
+// table, aged by each session search. New sessions take their search options
+// from the main search. Commands for one session run in order, one at a time;
+// different sessions run in parallel on a fixed set of worker threads.
+class SessionPool {
+public:
+    using Handler = std::function<void(Session&, const std::string&, std::ostream&)>;
+
+    // defaults is read when a session is created, from the thread calling submit
+    SessionPool(Handler command_handler, const Search& defaults)
+        : handler(std::move(command_handler)), defaults(defaults) {}
+    ~SessionPool() { stop_workers(); }
+
+    SessionPool(const SessionPool&) = delete;
+    SessionPool& operator=(const SessionPool&) = delete;
+
+    // Queues a command for the session, creating it on first use. "close"
+    // ends the running search, drops the commands still queued and then the session.
+    void submit(const std::string& id, const std::string& command);
+
+    // Ends the session's running search without waiting in its queue
+    void stop_search(const std::string& id);
+
+    // Finishes the queued work and restarts with the new number of workers
+    void set_workers(int workers);
+
+    // Blocks until every queued command has run
+    void wait_idle();
+
+    // True while a session is open or still has work, they all use the shared table
+    bool has_sessions();
+
+private:
+    Handler handler;
+    const Search& defaults;
+
+    std::unordered_map<std::string, std::shared_ptr<Session>> sessions;
+    std::deque<std::shared_ptr<Session>> ready; // sessions with pending commands
+    std::vector<std::thread> workers;
+    int num_workers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    int busy = 0;
+    bool stopping = false;
+
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::condition_variable idle_cv;
+
+    void start_workers();
+    void stop_workers();
+    void worker_loop();
+};
+
+// Serialized write to stdout, every line gets the prefix. Used by the main
+// loop and the workers so responses never interleave.
+void write_output(const std::string& text, const std::string& line_prefix = "");
@@ -0,0 +1,131 @@
+#include "SessionPool.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+void write_output(const std::string& text, const std::string& line_prefix) {
+    static std::mutex output_mutex;
+    std::lock_guard<std::mutex> lock(output_mutex);
+
+    if (line_prefix.empty()) {
+        std::cout << text;
+    } else {
+        std::istringstream lines(text);
+        std::string line;
+        while (std::getline(lines, line)) std::cout << line_prefix << line << '\n';
+    }
+    std::cout << std::flush;
+}
+
+void SessionPool::submit(const std::string& id, const std::string& command) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (workers.empty()) start_workers();
+
+    std::shared_ptr<Session>& slot = sessions[id];
+    if (!slot) slot = std::make_shared<Session>(id, defaults);
+    std::shared_ptr<Session> session = slot;
+
+    // Later commands with the same id start a fresh session; nobody reads the
+    // answers of the commands still queued, so they are dropped
+    uint64_t sequence = ++session->last_sequence;
+    if (command == "close") {
+        sessions.erase(id);
+        session->pending.clear();
+        session->stop_sequence = sequence;
+        session->stop_signal.store(true, std::memory_order_relaxed);
+    }
+
+    session->pending.emplace_back(sequence, command);
+    if (!session->scheduled) {
+        session->scheduled = true;
+        ready.push_back(session);
+        work_cv.notify_one();
+    }
+}
+
+void SessionPool::stop_search(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = sessions.find(id);
+    if (it == sessions.end()) return;
+
+    // Also reaches a search still waiting in the queue, not the commands submitted later
+    Session& session = *it->second;
+    session.stop_sequence = session.last_sequence;
+    session.stop_signal.store(true, std::memory_order_relaxed);
+}
+
+void SessionPool::set_workers(int workers_count) {
+    stop_workers();
+    std::lock_guard<std::mutex> lock(mutex);
+    num_workers = std::clamp(workers_count, 1, MAX_THREADS);
+}
+
+void SessionPool::wait_idle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle_cv.wait(lock, [this] { return ready.empty() && busy == 0; });
+}
+
+bool SessionPool::has_sessions() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !sessions.empty() || !ready.empty() || busy > 0;
+}
+
+// Called with the mutex held
+void SessionPool::start_workers() {
+    for (int i = 0; i < num_workers; ++i) {
+        workers.emplace_back([this] { worker_loop(); });
+    }
+}
+
+void SessionPool::stop_workers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_cv.notify_all();
+
+    for (std::thread& worker : workers) worker.join();
+    workers.clear();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = false;
+}
+
+// A session sits in the ready queue at most once, so only one worker touches
+// its game at a time and its commands keep their order
+void SessionPool::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        work_cv.wait(lock, [this] { return stopping || !ready.empty(); });
+        if (ready.empty()) return; // stopping, and the queue is drained
+
+        std::shared_ptr<Session> session = ready.front();
+        ready.pop_front();
+        auto [sequence, command] = std::move(session->pending.front());
+        session->pending.pop_front();
+        // Raised if a stop came in after this command was queued. Set under the mutex,
+        // so a stop or close after this point still reaches it
+        session->stop_signal.store(sequence <= session->stop_sequence, std::memory_order_relaxed);
+        busy++;
+        lock.unlock();
+
+        std::ostringstream response;
+        if (command == "close") {
+            response << "closed\n";
+        } else {
+            handler(*session, command, response);
+        }
+        write_output(response.str(), "session " + session->id + " ");
+
+        lock.lock();
+        busy--;
+        if (!session->pending.empty()) {
+            ready.push_back(session);
+            work_cv.notify_one();
+        } else {
+            session->scheduled = false;
+        }
+        if (ready.empty() && busy == 0) idle_cv.notify_all();
+    }
+}
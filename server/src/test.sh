@@ -27,9 +27,57 @@ makemove 2998
 getmoves 47
 makemove 3038
 getmoves 54
-makemove 19902
-promote 4
+makemove 48574
 quit
 EOF
 
-echo "Test finished."
\ No newline at end of file
+echo "Test finished."
+# A session stop reaches a search still waiting in the queue: the enginego
+# answers as soon as the perft ahead of it ends, not after its 10 s budget
+# (quit waits for it)
+echo "Starting session stop test..."
+
+start=$(date +%s)
+(
+echo "session t perft 5"
+echo "session t enginego movetime 10000"
+echo "session t stop"
+sleep 2
+echo "quit"
+) | ./engine | grep -v " info "
+elapsed=$(( $(date +%s) - start ))
+
+if [ "$elapsed" -lt 5 ]; then
+    echo "Session stop test passed (${elapsed} s)"
+else
+    echo "Session stop test FAILED: the queued search ran its full budget (${elapsed} s)"
+    exit 1
+fi
+
+# Invalid FENs are rejected and leave the current position untouched
+echo "Starting invalid FEN test..."
+
+invalid_fens=(
+    "8/8/8/8/8/8/8/4K3 w - - 0 1"
+    "4k3/8/8/8/8/8/8/4K3 x - - 0 1"
+    "4k3/8/8/8/8/8/8/4K3 w - e3 0 1"
+    "4k3/8/8/8/8/8/8/4R1K1 w - - 0 1"
+)
+
+for fen in "${invalid_fens[@]}"; do
+    if ! printf 'position fen %s\nquit\n' "$fen" | ./engine | grep -qx "error"; then
+        echo "Invalid FEN test FAILED: accepted '$fen'"
+        exit 1
+    fi
+done
+echo "Invalid FEN test passed"
+
+# Perft suite: every position must match its reference node count
+echo "Starting perft suite..."
+
+if make -s perft_bench && ./perft_bench; then
+    echo "Perft suite passed"
+else
+    echo "Perft suite FAILED"
+    exit 1
+fi
@@ -2,15 +2,32 @@
 #include <string>
 #include <sstream>
 #include <unordered_map>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <thread>
 #include "./game/Game.h"
 #include "./board_state/BoardState.h"
 #include "./search/Search.h"
+#include "./perft/Perft.h"
+#include "./session/SessionPool.h"
+
+void run_session_command(Session& session, const std::string& line, std::ostream& out);
 
 Game game;
 Search search;
+SessionPool sessions(run_session_command, search);
+
+// go and enginego run on their own thread so the loop can still read "stop" and "ponderhit"
+std::thread search_thread;
+std::atomic<bool> stop_signal{false};
+std::atomic<bool> ponder_signal{false};
 
 enum class Command {
-    UCI, ISREADY, UCINEWGAME, ENGINEMOVES, GETMOVES, USERMOVES, PROMOTE, QUIT, UNKNOWN
+    UCI, ISREADY, UCINEWGAME, ENGINEMOVES, GETMOVES, USERMOVES, POSITION, SETOPTION, PERFT, SESSION,
+    GO, STOP, PONDERHIT, QUIT, UNKNOWN
 };
 
 Command obtain_command(const std::string& token) {
@@ -20,8 +37,14 @@ Command obtain_command(const std::string& token) {
         {"ucinewgame", Command::UCINEWGAME},
         {"enginego", Command::ENGINEMOVES},
         {"getmoves", Command::GETMOVES},
-        {"promote", Command::PROMOTE},
         {"makemove", Command::USERMOVES},
+        {"position", Command::POSITION},
+        {"setoption", Command::SETOPTION},
+        {"perft", Command::PERFT},
+        {"session", Command::SESSION},
+        {"go", Command::GO},
+        {"stop", Command::STOP},
+        {"ponderhit", Command::PONDERHIT},
         {"quit", Command::QUIT}
     };
 
@@ -29,95 +52,412 @@ Command obtain_command(const std::string& token) {
     return it != command_map.end() ? it->second : Command::UNKNOWN;
 }
 
-void uci_loop() {
-    std::string line;
+// position startpos [moves m1 m2 ...] | position fen <fen> [moves m1 m2 ...]
+// The current game is only replaced when the whole command is valid
+bool set_position(Game& game, std::istringstream& iss, std::ostream& out) {
+    std::string token;
+    iss >> token;
 
-    while (std::getline(std::cin, line)) {
-        std::istringstream iss(line);
-        std::string token;
+    Game new_game;
+
+    if (token == "fen") {
+        std::string fen, field;
+        while (iss >> field && field != "moves") fen += field + " ";
+        if (!new_game.set_fen(fen)) {
+            out << "Invalid fen: " << fen << "\n";
+            return false;
+        }
+        token = field;
+    } else if (token == "startpos") {
         iss >> token;
+    } else {
+        out << "Invalid position: " << token << "\n";
+        return false;
+    }
 
-        switch (obtain_command(token)) {
-            case Command::UCI:
-                std::cout << "id name Kingslayer Engine\n"; // Nombre de tu motor
-                std::cout << "id author AresNeutron\n";      // Tu nombre
-                std::cout << "uciok\n"; // Indica que el protocolo UCI está listo
-                break;
+    if (token == "moves") {
+        std::string move_str;
+        while (iss >> move_str) {
+            uint16_t move_code = new_game.find_move(move_str);
+            if (move_code == 0) {
+                out << "Invalid move: " << move_str << "\n";
+                return false;
+            }
+            new_game.play_move(move_code);
+        }
+    }
 
-            case Command::ISREADY:
-                std::cout << "readyok\n";
-                break;
+    game = new_game;
+    return true;
+}
+
+// [depth N] [movetime MS] [nodes N] [wtime MS] [btime MS] [winc MS] [binc MS] [movestogo N] [infinite]
+SearchLimits parse_limits(std::istringstream& iss) {
+    SearchLimits limits;
+    std::string option;
+
+    while (iss >> option) {
+        if (option == "depth") iss >> limits.depth;
+        else if (option == "movetime") iss >> limits.movetime;
+        else if (option == "nodes") iss >> limits.nodes;
+        else if (option == "wtime") iss >> limits.time[WHITE];
+        else if (option == "btime") iss >> limits.time[BLACK];
+        else if (option == "winc") iss >> limits.inc[WHITE];
+        else if (option == "binc") iss >> limits.inc[BLACK];
+        else if (option == "movestogo") iss >> limits.movestogo;
+        else if (option == "infinite") limits.infinite = true;
+        else if (option == "ponder") limits.ponder = true;
+    }
+    return limits;
+}
+
+// Coordinate notation for bestmove, "0000" when there is no move
+std::string uci_move(uint16_t move) {
+    return move == 0 ? "0000" : move_to_string(move);
+}
+
+// Sends every flushed chunk straight to stdout, so info lines show up while searching
+class SearchOutputBuf : public std::stringbuf {
+    int sync() override {
+        write_output(str());
+        str("");
+        return 0;
+    }
+};
+
+void wait_for_search() {
+    if (search_thread.joinable()) search_thread.join();
+}
+
+void stop_search() {
+    stop_signal.store(true, std::memory_order_relaxed);
+    wait_for_search();
+    stop_signal.store(false, std::memory_order_relaxed);
+    ponder_signal.store(false, std::memory_order_relaxed);
+}
+
+// Runs the job on the search thread, its output goes out as it is flushed
+void start_search(std::function<void(std::ostream&)> job, bool ponder = false) {
+    wait_for_search();
+    ponder_signal.store(ponder, std::memory_order_relaxed);
+
+    search_thread = std::thread([job = std::move(job)]() {
+        SearchOutputBuf buffer;
+        std::ostream out(&buffer);
+        job(out);
+        out.flush();
+    });
+}
+
+// go: searches a copy of the game and answers "bestmove <move>". UCI forbids the
+// bestmove of "go infinite" or "go ponder" before stop/ponderhit, even when the
+// search runs out of depth
+void start_go(const SearchLimits& limits) {
+    start_search([limits, search_game = game](std::ostream& out) mutable {
+        uint16_t best = search.iterative_deepening(search_game, limits, &out);
+
+        while ((limits.infinite || ponder_signal.load(std::memory_order_relaxed)) &&
+               !stop_signal.load(std::memory_order_relaxed)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        out << "bestmove " << uci_move(best) << std::endl;
+    }, limits.ponder);
+}
+
+// enginego: plays on the main game from the search thread, the loop makes every
+// other game command wait for it
+void start_engine_moves(const SearchLimits& limits) {
+    start_search([limits](std::ostream& out) {
+        search.engine_moves(game, limits, out);
+    });
+}
+
+// setoption name <id> value <x>
+void parse_option(std::istringstream& iss, std::string& name, std::string& value) {
+    std::string token;
+
+    iss >> token; // "name"
+    while (iss >> token && token != "value") name += (name.empty() ? "" : " ") + token;
+    iss >> value;
+}
+
+// Options that belong to one Search, false if the name is not one of them. Throws on a bad value
+bool set_search_option(Search& target, const std::string& name, const std::string& value) {
+    if (name == "Threads") {
+        target.set_threads(std::stoi(value));
+    } else if (name == "NullMove" || name == "LMR") {
+        if (value != "true" && value != "false") throw std::invalid_argument(value);
+        if (name == "NullMove") target.set_null_move(value == "true");
+        else target.set_lmr(value == "true");
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Sessions created afterwards start with the main search's Threads/NullMove/LMR
+void set_option(std::istringstream& iss, std::ostream& out) {
+    std::string name, value;
+    parse_option(iss, name, value);
+
+    try {
+        if (set_search_option(search, name, value)) return;
+
+        if (name == "Hash") {
+            int size_mb = std::clamp(std::stoi(value), 1, 4096);
+            sessions.wait_idle(); // the table is shared with the sessions
+            search.set_hash_size(size_mb);
+        } else if (name == "Workers") {
+            sessions.set_workers(std::stoi(value));
+        } else {
+            out << "Unknown option: " << name << "\n";
+        }
+    } catch (...) {
+        out << "Invalid value for " << name << ": " << value << "\n";
+    }
+}
+
+// Runs one command against a game, returns false on quit
+bool execute(Game& game, Search& search, const std::string& line, std::ostream& out) {
+    std::istringstream iss(line);
+    std::string token;
+    iss >> token;
+
+    switch (obtain_command(token)) {
+        case Command::UCI:
+            out << "id name Kingslayer Engine\n"; // Nombre de tu motor
+            out << "id author AresNeutron\n";      // Tu nombre
+            out << "option name Threads type spin default 1 min 1 max " << MAX_THREADS << "\n";
+            out << "option name Hash type spin default " << TranspositionTable::DEFAULT_SIZE_MB
+                << " min 1 max 4096\n";
+            out << "option name Workers type spin default " << std::max(1u, std::thread::hardware_concurrency())
+                << " min 1 max " << MAX_THREADS << "\n";
+            out << "option name NullMove type check default true\n";
+            out << "option name LMR type check default true\n";
+            out << "uciok\n"; // Indica que el protocolo UCI está listo
+            break;
 
-            case Command::UCINEWGAME:
-                game = Game();
-                search = Search();
-                std::cout << "New Game Started\n";
-                std::cout << "readyok\n";
+        case Command::ISREADY:
+            out << "readyok\n";
+            break;
+
+        case Command::UCINEWGAME:
+            game = Game();
+            // Options like Threads/Hash survive a new game. The table is shared with
+            // the sessions, it is only cleared while none is open
+            if (!sessions.has_sessions()) search.clear_hash();
+            out << "New Game Started\n";
+            out << "readyok\n";
+            break;
+
+        // enginego [depth N] [movetime MS] [nodes N] [wtime MS] ...
+        case Command::ENGINEMOVES:
+            search.engine_moves(game, parse_limits(iss), out);
+            break;
+
+        // Synchronous go, the uci loop runs the main game's go on the search thread instead
+        case Command::GO: {
+            SearchLimits limits = parse_limits(iss);
+            if (limits.infinite || limits.ponder) {
+                out << "go infinite/ponder needs the search thread, not available here\n";
+                out << "error\n";
                 break;
+            }
+            uint16_t best = search.iterative_deepening(game, limits, &out);
+            out << "bestmove " << uci_move(best) << "\n";
+            break;
+        }
+
+        case Command::STOP:      // nothing is searching in the background here
+        case Command::PONDERHIT:
+            break;
 
-                // disabled by now
-            case Command::ENGINEMOVES:{
-                search.engine_moves(game);
+        case Command::GETMOVES: {
+            int square;
+            iss >> square;
+            if (square < 0 || square > 63) {
+                out << "Invalid square\n";
+                out << "error" << std::endl;
                 break;
             }
 
-            case Command::GETMOVES: {
-                int square;
-                iss >> square;
-                if (square < 0 || square > 63) {
-                    std::cout << "Invalid square\n";
-                    std::cout << "error" << std::endl;
-                    break;
-                }
+            MoveList moves;
+            game.get_legal_moves(square, moves, out);
 
-                std::vector<uint16_t> movesVector = game.get_legal_moves(square);
+            for (uint16_t moveCode : moves) {
+                out << moveCode << std::endl;
+            }
 
-                for (uint16_t moveCode : movesVector) {
-                    std::cout << moveCode << std::endl;
-                }
+            out << "readyok\n";
+            break;
+        }
 
-                std::cout << "readyok\n";
+        // The code comes from the client, anything the generator would not produce is refused
+        case Command::USERMOVES: {
+            uint16_t move_code = 0;
+            if (!(iss >> move_code) || !game.is_legal(move_code)) {
+                out << "Illegal move: " << move_code << "\n";
+                out << "error" << std::endl;
                 break;
             }
 
-            case Command::USERMOVES: {
-                uint16_t move_code;
-                iss >> move_code;
+            game.user_moves(move_code, out);
+            break;
+        }
 
-                game.user_moves(move_code);
-                break;
+        case Command::SETOPTION:
+            set_option(iss, out);
+            break;
+
+        case Command::POSITION: {
+            if (!set_position(game, iss, out)) {
+                out << "error" << std::endl;
             }
+            break;
+        }
+
+        // perft <depth> | perft divide <depth>
+        case Command::PERFT: {
+            std::string arg;
+            iss >> arg;
 
-            case Command::PROMOTE: {
-                int promotion;
-                iss >> promotion;
-                
-                game.user_promotion(promotion);
+            bool divide = (arg == "divide");
+            if (divide) iss >> arg;
+
+            int depth = 0;
+            try { depth = std::stoi(arg); } catch (...) { depth = 0; }
+            if (depth < 1 || depth >= MAX_PLY) {
+                out << "Invalid depth\n";
+                out << "error" << std::endl;
                 break;
             }
 
+            auto start = std::chrono::steady_clock::now();
+            uint64_t nodes = divide ? perft_divide(game, depth, out) : perft(game, depth);
+            int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
 
-            case Command::QUIT:
-                return;
+            out << "nodes " << nodes << " time " << ms
+                      << " nps " << (nodes * 1000 / (ms > 0 ? ms : 1)) << "\n";
+            out << "readyok\n";
+            break;
+        }
 
-            default:
-                std::cout << "Unknown command: " << token << "\n";
-                std::cout << "readyok\n";
-                break;
+        case Command::QUIT:
+            return false;
+
+        default:
+            out << "Unknown command: " << token << "\n";
+            out << "readyok\n";
+            break;
+    }
+    return true;
+}
+
+
+// Commands a session may run: the ones that only touch its own game
+void run_session_command(Session& session, const std::string& line, std::ostream& out) {
+    std::istringstream iss(line);
+    std::string token;
+    iss >> token;
+
+    switch (obtain_command(token)) {
+        // Search options apply to this session only, Hash and Workers are process wide
+        case Command::SETOPTION: {
+            std::string name, value;
+            parse_option(iss, name, value);
+            try {
+                if (!set_search_option(session.search, name, value)) {
+                    out << "Not available in a session: setoption name " << name << "\n";
+                    out << "error\n";
+                }
+            } catch (...) {
+                out << "Invalid value for " << name << ": " << value << "\n";
+            }
+            break;
         }
-        std::cout << std::flush;
+
+        case Command::UCI:
+        case Command::SESSION:
+        case Command::PONDERHIT:
+        case Command::QUIT:
+            out << "Not available in a session: " << token << "\n";
+            out << "error\n";
+            break;
+
+        case Command::UCINEWGAME:
+            session.game = Game(); // the shared hash stays, other sessions are using it
+            out << "New Game Started\n";
+            out << "readyok\n";
+            break;
+
+        default:
+            execute(session.game, session.search, line, out);
+            break;
     }
 }
 
-int main() {
-    init_king_knight_lookups();
-    init_pawn_lookups();
-    init_ray_tables();
-    generate_magic_bitboards();
 
+void uci_loop() {
+    std::string line;
+
+    while (std::getline(std::cin, line)) {
+        std::istringstream iss(line);
+        std::string token, id;
+        iss >> token;
+
+        // session <id> <command>: routed to the session pool, answered asynchronously
+        if (obtain_command(token) == Command::SESSION) {
+            std::string command;
+            iss >> id;
+            std::getline(iss >> std::ws, command);
+            if (id.empty() || command.empty()) {
+                write_output("Usage: session <id> <command>\nerror\n");
+            } else if (command == "stop") {
+                sessions.stop_search(id); // skips the session's queue, the search answers as usual
+            } else {
+                sessions.submit(id, command);
+            }
+            continue;
+        }
+
+        // go/stop drive the search thread; isready is answered even while it searches,
+        // every other command waits for the search to end first
+        Command command = obtain_command(token);
+        if (command == Command::GO) {
+            start_go(parse_limits(iss));
+            continue;
+        }
+        if (command == Command::ENGINEMOVES) {
+            start_engine_moves(parse_limits(iss));
+            continue;
+        }
+        if (command == Command::PONDERHIT) {
+            ponder_signal.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        if (command == Command::STOP || command == Command::QUIT) {
+            stop_search();
+        } else if (command != Command::ISREADY) {
+            wait_for_search();
+        }
+
+        std::ostringstream out;
+        bool running = execute(game, search, line, out);
+        write_output(out.str());
+        if (!running) return;
+    }
+
+    stop_search();
+}
+
+int main() {
     std::ios_base::sync_with_stdio(false);
     std::cin.tie(NULL);
 
+    search.set_stop_signal(&stop_signal);
+    search.set_ponder_signal(&ponder_signal);
+
     uci_loop();
     return 0;
 }